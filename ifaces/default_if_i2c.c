@@ -11,6 +11,7 @@
 #include <string.h>
 #include <driver/i2c.h>
 #include <driver/gpio.h>
+#include <rom/ets_sys.h>
 #include "ssd1306.h"
 #include "ssd1306_default_if.h"
 
@@ -25,12 +26,14 @@ static const int I2CDisplaySpeed = CONFIG_SSD1306_DEFAULT_I2C_SPEED;
 static const int I2CPortNumber = CONFIG_SSD1306_DEFAULT_I2C_PORT_NUMBER;
 static const int SCLPin = CONFIG_SSD1306_DEFAULT_I2C_SCL_PIN;
 static const int SDAPin = CONFIG_SSD1306_DEFAULT_I2C_SDA_PIN;
+static const int ResetPulseUs = CONFIG_SSD1306_RESET_PULSE_US;
 
 static const int SSD1306_I2C_COMMAND_MODE = 0x00;
 static const int SSD1306_I2C_DATA_MODE = 0x40;
 
 static bool I2CDefaultWriteBytes( int Address, bool IsCommand, const uint8_t* Data, size_t DataLength );
 static bool I2CDefaultWriteCommand( struct SSD1306_Device* Display, SSDCmd Command );
+static bool I2CDefaultWriteCommands( struct SSD1306_Device* Display, const uint8_t* Commands, size_t Length );
 static bool I2CDefaultWriteData( struct SSD1306_Device* Display, const uint8_t* Data, size_t DataLength );
 static bool I2CDefaultReset( struct SSD1306_Device* Display );
 
@@ -101,14 +104,15 @@ bool SSD1306_I2CMasterAttachDisplayDefault( struct SSD1306_Device* DisplayHandle
         ESP_ERROR_CHECK_NONFATAL( gpio_set_level( RSTPin, 1 ), return false );
     }
 
-    return SSD1306_IsDisplayAttached( I2CAddress ) && SSD1306_Init_I2C( DisplayHandle,
+    return SSD1306_IsDisplayAttached( I2CAddress ) && SSD1306_Init_I2C_Ex( DisplayHandle,
         Width,
         Height,
         I2CAddress,
         RSTPin,
         I2CDefaultWriteCommand,
         I2CDefaultWriteData,
-        I2CDefaultReset
+        I2CDefaultReset,
+        I2CDefaultWriteCommands
     );
 }
 
@@ -141,6 +145,17 @@ static bool I2CDefaultWriteCommand( struct SSD1306_Device* Display, SSDCmd Comma
     return I2CDefaultWriteBytes( Display->Address, true, ( const uint8_t* ) &CommandByte, 1 );
 }
 
+/*
+ * With the continuation bit clear in the control byte everything that
+ * follows is a command, so a whole sequence fits in one transaction.
+ */
+static bool I2CDefaultWriteCommands( struct SSD1306_Device* Display, const uint8_t* Commands, size_t Length ) {
+    NullCheck( Display, return false );
+    NullCheck( Commands, return false );
+
+    return I2CDefaultWriteBytes( Display->Address, true, Commands, Length );
+}
+
 static bool I2CDefaultWriteData( struct SSD1306_Device* Display, const uint8_t* Data, size_t DataLength ) {
     NullCheck( Display, return false );
     NullCheck( Data, return false );
@@ -153,8 +168,11 @@ static bool I2CDefaultReset( struct SSD1306_Device* Display ) {
 
     if ( Display->RSTPin >= 0 ) {
         ESP_ERROR_CHECK_NONFATAL( gpio_set_level( Display->RSTPin, 0 ), return true );
-            vTaskDelay( pdMS_TO_TICKS( 100 ) );
+            ets_delay_us( ResetPulseUs );
         ESP_ERROR_CHECK_NONFATAL( gpio_set_level( Display->RSTPin, 1 ), return true );
+
+        /* Give the controller as long again to come out of reset */
+        ets_delay_us( ResetPulseUs );
     }
 
     return true;
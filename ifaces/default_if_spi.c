@@ -12,6 +12,7 @@
 #include <driver/spi_master.h>
 #include <driver/gpio.h>
 #include <freertos/task.h>
+#include <rom/ets_sys.h>
 #include "ssd1306.h"
 #include "ssd1306_default_if.h"
 
@@ -28,12 +29,14 @@ static const int SPIFrequency = CONFIG_SSD1306_DEFAULT_SPI_FREQUENCY;
 static const int MOSIPin = CONFIG_SSD1306_DEFAULT_SPI_MOSI_PIN;
 static const int SCLKPin = CONFIG_SSD1306_DEFAULT_SPI_SCLK_PIN;
 static const int DCPin = CONFIG_SSD1306_DEFAULT_SPI_DC_PIN;
+static const int ResetPulseUs = CONFIG_SSD1306_RESET_PULSE_US;
 
 static const int SSD1306_SPI_Command_Mode = 0;
 static const int SSD1306_SPI_Data_Mode = 1;
 
 static bool SPIDefaultWriteBytes( spi_device_handle_t SPIHandle, int WriteMode, const uint8_t* Data, size_t DataLength );
 static bool SPIDefaultWriteCommand( struct SSD1306_Device* DeviceHandle, SSDCmd Command );
+static bool SPIDefaultWriteCommands( struct SSD1306_Device* DeviceHandle, const uint8_t* Commands, size_t Length );
 static bool SPIDefaultWriteData( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, size_t DataLength );
 static bool SPIDefaultReset( struct SSD1306_Device* DeviceHandle );
 
@@ -75,7 +78,7 @@ bool SSD1306_SPIMasterAttachDisplayDefault( struct SSD1306_Device* DeviceHandle,
 
     ESP_ERROR_CHECK_NONFATAL( spi_bus_add_device( SPIHost, &SPIDeviceConfig, &SPIDeviceHandle ), return false );
 
-    return SSD1306_Init_SPI( DeviceHandle,
+    return SSD1306_Init_SPI_Ex( DeviceHandle,
         Width,
         Height,
         RSTForThisDisplay,
@@ -83,7 +86,8 @@ bool SSD1306_SPIMasterAttachDisplayDefault( struct SSD1306_Device* DeviceHandle,
         SPIDeviceHandle,
         SPIDefaultWriteCommand,
         SPIDefaultWriteData,
-        SPIDefaultReset
+        SPIDefaultReset,
+        SPIDefaultWriteCommands
     );
 }
 
@@ -117,6 +121,16 @@ static bool SPIDefaultWriteCommand( struct SSD1306_Device* DeviceHandle, SSDCmd
     return SPIDefaultWriteBytes( DeviceHandle->SPIHandle, SSD1306_SPI_Command_Mode, &CommandByte, 1 );
 }
 
+/*
+ * DC stays low for the whole transfer so every byte is taken as a command.
+ */
+static bool SPIDefaultWriteCommands( struct SSD1306_Device* DeviceHandle, const uint8_t* Commands, size_t Length ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->SPIHandle, return false );
+
+    return SPIDefaultWriteBytes( DeviceHandle->SPIHandle, SSD1306_SPI_Command_Mode, Commands, Length );
+}
+
 static bool SPIDefaultWriteData( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, size_t DataLength ) {
     NullCheck( DeviceHandle, return false );
     NullCheck( DeviceHandle->SPIHandle, return false );
@@ -129,8 +143,11 @@ static bool SPIDefaultReset( struct SSD1306_Device* DeviceHandle ) {
 
     if ( DeviceHandle->RSTPin >= 0 ) {
         ESP_ERROR_CHECK_NONFATAL( gpio_set_level( DeviceHandle->RSTPin, 0 ), return false );
-            vTaskDelay( pdMS_TO_TICKS( 100 ) );
+            ets_delay_us( ResetPulseUs );
         ESP_ERROR_CHECK_NONFATAL( gpio_set_level( DeviceHandle->RSTPin, 1 ), return false );
+
+        /* Give the controller as long again to come out of reset */
+        ets_delay_us( ResetPulseUs );
     }
 
     return true;
@@ -14,15 +14,10 @@
 #include <esp_heap_caps.h>
 
 #include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_strip.h"
 
-#define COM_Disable_LR_Remap 0
-#define COM_Enable_LR_Remap BIT( 5 )
-
-#define COM_Pins_Sequential 0
-#define COM_Pins_Alternative BIT( 4 )
-
-#define COM_ScanDir_LR 0
-#define COM_ScanDir_RL 1
+static const SSD1306_ControllerType DefaultController = ( SSD1306_ControllerType ) CONFIG_SSD1306_DEFAULT_CONTROLLER;
 
 static bool SSD1306_Init( struct SSD1306_Device* DeviceHandle, int Width, int Height );
 
@@ -33,11 +28,99 @@ bool SSD1306_WriteCommand( struct SSD1306_Device* DeviceHandle, SSDCmd SSDComman
     return ( DeviceHandle->WriteCommand ) ( DeviceHandle, SSDCommand );
 }
 
+/*
+ * Number of bytes in the current column and page window, 0 if it is not known.
+ */
+static int GetWindowSize( struct SSD1306_Device* DeviceHandle ) {
+    struct SSD1306_ControllerState* State = &DeviceHandle->State;
+
+    if ( State->ColumnStart == SSD1306_State_Unknown || State->ColumnEnd == SSD1306_State_Unknown ) {
+        return 0;
+    }
+
+    if ( State->PageStart == SSD1306_State_Unknown || State->PageEnd == SSD1306_State_Unknown ) {
+        return 0;
+    }
+
+    if ( State->ColumnEnd < State->ColumnStart || State->PageEnd < State->PageStart ) {
+        return 0;
+    }
+
+    return ( ( State->ColumnEnd - State->ColumnStart ) + 1 ) * ( ( State->PageEnd - State->PageStart ) + 1 );
+}
+
 bool SSD1306_WriteData( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength ) {
+    int WindowSize = 0;
+
     NullCheck( DeviceHandle, return false );
     NullCheck( DeviceHandle->WriteData, return false );
 
-    return ( DeviceHandle->WriteData ) ( DeviceHandle, Data, DataLength );
+    if ( ( DeviceHandle->WriteData ) ( DeviceHandle, Data, DataLength ) == false ) {
+        /* No telling how far the address pointer got */
+        DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+        return false;
+    }
+
+    if ( DeviceHandle->State.WindowFill != SSD1306_State_Unknown && ( WindowSize = GetWindowSize( DeviceHandle ) ) > 0 ) {
+        DeviceHandle->State.WindowFill = ( int ) ( ( DeviceHandle->State.WindowFill + DataLength ) % WindowSize );
+    } else {
+        DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+    }
+
+    return true;
+}
+
+/*
+ * Sends a command along with its arguments, returns false if any byte failed.
+ * Goes out as one transaction when the interface supports it.
+ */
+static bool WriteCommandSequence( struct SSD1306_Device* DeviceHandle, const uint8_t* Commands, size_t Length ) {
+    size_t i = 0;
+
+    if ( DeviceHandle->WriteCommands != NULL ) {
+        return ( DeviceHandle->WriteCommands ) ( DeviceHandle, Commands, Length );
+    }
+
+    for ( i = 0; i < Length; i++ ) {
+        if ( SSD1306_WriteCommand( DeviceHandle, ( SSDCmd ) Commands[ i ] ) == false ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Sends Commands unless Value is what the controller already has.
+ * The shadow is only updated if the commands went out.
+ */
+static void WriteShadowed( struct SSD1306_Device* DeviceHandle, int* Shadow, int Value, const uint8_t* Commands, size_t Length ) {
+    if ( *Shadow == Value ) {
+        return;
+    }
+
+    *Shadow = ( WriteCommandSequence( DeviceHandle, Commands, Length ) == true ) ? Value : SSD1306_State_Unknown;
+}
+
+void SSD1306_InvalidateState( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return );
+
+    DeviceHandle->State.Contrast = SSD1306_State_Unknown;
+    DeviceHandle->State.Inverted = SSD1306_State_Unknown;
+    DeviceHandle->State.HFlip = SSD1306_State_Unknown;
+    DeviceHandle->State.VFlip = SSD1306_State_Unknown;
+    DeviceHandle->State.AddressMode = SSD1306_State_Unknown;
+    DeviceHandle->State.DisplayOn = SSD1306_State_Unknown;
+    DeviceHandle->State.ShowRAM = SSD1306_State_Unknown;
+    DeviceHandle->State.StartLine = SSD1306_State_Unknown;
+    DeviceHandle->State.ColumnStart = SSD1306_State_Unknown;
+    DeviceHandle->State.ColumnEnd = SSD1306_State_Unknown;
+    DeviceHandle->State.PageStart = SSD1306_State_Unknown;
+    DeviceHandle->State.PageEnd = SSD1306_State_Unknown;
+    DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+
+    /* Nor about what display RAM holds */
+    DeviceHandle->PageHashValid = 0;
 }
 
 void SSD1306_SetMuxRatio( struct SSD1306_Device* DeviceHandle, uint8_t Ratio ) {
@@ -54,49 +137,85 @@ void SSD1306_SetDisplayOffset( struct SSD1306_Device* DeviceHandle, uint8_t Offs
     SSD1306_WriteCommand( DeviceHandle, Offset );
 }
 
+/*
+ * The display shows RAM starting from Line, rows above it wrap around to the bottom.
+ */
 void SSD1306_SetDisplayStartLine( struct SSD1306_Device* DeviceHandle, int Line ) {
+    uint8_t Commands[ 2 ];
+    size_t Length = 1;
+
     NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Controller, return );
 
-    SSD1306_WriteCommand( DeviceHandle, 
-        SSDCmd_Set_Display_Start_Line + ( uint32_t ) ( Line & 0x1F )
-    );
+    Line = ( ( Line % DeviceHandle->Controller->MaxHeight ) + DeviceHandle->Controller->MaxHeight ) % DeviceHandle->Controller->MaxHeight;
+
+    if ( DeviceHandle->Screen.PixelFormat == PixelFormat_Mono ) {
+        Commands[ 0 ] = SSDCmd_Set_Display_Start_Line + ( uint8_t ) Line;
+    } else {
+        Commands[ 0 ] = SSDCmd_Set_Gray_Start_Line;
+        Commands[ 1 ] = ( uint8_t ) Line;
+        Length = 2;
+    }
+
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.StartLine, Line, Commands, Length );
 }
 
-/*
- * This is all a big giant mystery that I have yet to figure out.
- * Beware all ye who enter.
- */
-static void SetCOMPinConfiguration( struct SSD1306_Device* DeviceHandle, uint32_t RemapCFG, uint32_t PinCFG, int ScanDir ) {
+void SSD1306_SetContrast( struct SSD1306_Device* DeviceHandle, uint8_t Contrast ) {
+    uint8_t Commands[ 2 ];
+
     NullCheck( DeviceHandle, return );
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_COM_Pin_Config );
-    SSD1306_WriteCommand( DeviceHandle, ( uint8_t ) ( RemapCFG | PinCFG | BIT( 1 ) ) );
+    Commands[ 0 ] = SSDCmd_Set_Contrast;
+    Commands[ 1 ] = Contrast;
 
-    SSD1306_WriteCommand( DeviceHandle, 
-        ( ScanDir == COM_ScanDir_LR ) ? SSDCmd_Set_Display_VFlip_Off : SSDCmd_Set_Display_VFlip_On
-    );
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.Contrast, Contrast, Commands, sizeof( Commands ) );
 }
 
-void SSD1306_SetContrast( struct SSD1306_Device* DeviceHandle, uint8_t Contrast ) {
-    NullCheck( DeviceHandle, return );
+/*
+ * Grayscale controllers keep normal, all on, all off and inverted in a single display mode register.
+ * A command sent there for ShowRAM also sets inversion and the other way around, so both
+ * shadows are taken from the command that went out.
+ */
+static void WriteDisplayMode( struct SSD1306_Device* DeviceHandle, int* Shadow, int Value, uint8_t Command ) {
+    bool Written = false;
+
+    if ( DeviceHandle->Screen.PixelFormat == PixelFormat_Mono ) {
+        WriteShadowed( DeviceHandle, Shadow, Value, &Command, 1 );
+        return;
+    }
+
+    if ( *Shadow == Value ) {
+        return;
+    }
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Contrast );
-    SSD1306_WriteCommand( DeviceHandle, Contrast );
+    Written = WriteCommandSequence( DeviceHandle, &Command, 1 );
+
+    /* All pixels on says nothing about inversion, 0xA4 or 0xA7 will have to go out again */
+    DeviceHandle->State.ShowRAM = ( Written == true ) ? ( Command != SSDCmd_Set_Display_Ignore_RAM ) : SSD1306_State_Unknown;
+    DeviceHandle->State.Inverted = ( Written == true && Command != SSDCmd_Set_Display_Ignore_RAM ) ? ( Command == SSDCmd_Set_Inverted_Display ) : SSD1306_State_Unknown;
 }
 
 void SSD1306_EnableDisplayRAM( struct SSD1306_Device* DeviceHandle ) {
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Display_Show_RAM );
+    WriteDisplayMode( DeviceHandle, &DeviceHandle->State.ShowRAM, true, SSDCmd_Set_Display_Show_RAM );
 }
 
 void SSD1306_DisableDisplayRAM( struct SSD1306_Device* DeviceHandle ) {
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Display_Ignore_RAM );
+    WriteDisplayMode( DeviceHandle, &DeviceHandle->State.ShowRAM, false, SSDCmd_Set_Display_Ignore_RAM );
 }
 
 void SSD1306_SetInverted( struct SSD1306_Device* DeviceHandle, bool Inverted ) {
+    uint8_t Command = ( Inverted == true ) ? SSDCmd_Set_Inverted_Display : SSDCmd_Set_Normal_Display;
+
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, ( Inverted == true ) ? SSDCmd_Set_Inverted_Display : SSDCmd_Set_Normal_Display );
+
+    /* Grayscale controllers use 0xA6 for all pixels off, their normal display is 0xA4 */
+    if ( Inverted == false && DeviceHandle->Screen.PixelFormat != PixelFormat_Mono ) {
+        Command = SSDCmd_Set_Display_Show_RAM;
+    }
+
+    WriteDisplayMode( DeviceHandle, &DeviceHandle->State.Inverted, Inverted, Command );
 }
 
 void SSD1306_SetDisplayClocks( struct SSD1306_Device* DeviceHandle, uint32_t DisplayClockDivider, uint32_t OSCFrequency ) {
@@ -109,83 +228,668 @@ void SSD1306_SetDisplayClocks( struct SSD1306_Device* DeviceHandle, uint32_t Dis
     SSD1306_WriteCommand( DeviceHandle, ( ( OSCFrequency << 4 ) | DisplayClockDivider ) );
 }
 
-/* There is no documentation for this command, but it is required during init. */
-static void EnableChargePumpRegulator( struct SSD1306_Device* DeviceHandle ) {
+void SSD1306_DisplayOn( struct SSD1306_Device* DeviceHandle ) {
+    const uint8_t Command = SSDCmd_Set_Display_On;
+
     NullCheck( DeviceHandle, return );
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.DisplayOn, true, &Command, 1 );
+}
+
+void SSD1306_DisplayOff( struct SSD1306_Device* DeviceHandle ) {
+    const uint8_t Command = SSDCmd_Set_Display_Off;
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Enable_Charge_Pump_Regulator );
-    SSD1306_WriteCommand( DeviceHandle, 0x14 ); /* MAGIC NUMBER */
+    NullCheck( DeviceHandle, return );
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.DisplayOn, false, &Command, 1 );
 }
 
-void SSD1306_DisplayOn( struct SSD1306_Device* DeviceHandle ) {
+void SSD1306_SetDisplayAddressMode( struct SSD1306_Device* DeviceHandle, SSD1306_AddressMode AddressMode ) {
+    uint8_t Commands[ 2 ];
+
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Display_On );
+    CheckBounds( ( DeviceHandle->Controller->AddressModes & BIT( AddressMode ) ) == 0, return );
+
+    Commands[ 0 ] = SSDCmd_Set_Memory_Addressing_Mode;
+    Commands[ 1 ] = AddressMode;
+
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.AddressMode, AddressMode, Commands, sizeof( Commands ) );
+
+    /* The column and page window commands do not apply in page mode */
+    if ( AddressMode == AddressMode_Page ) {
+        DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+    }
 }
 
-void SSD1306_DisplayOff( struct SSD1306_Device* DeviceHandle ) {
+static bool HasAddressMode( struct SSD1306_Device* DeviceHandle, SSD1306_AddressMode AddressMode ) {
+    return ( DeviceHandle->Controller->AddressModes & BIT( AddressMode ) ) ? true : false;
+}
+
+/*
+ * Sets one axis of the window, unless it is already set and Force is false.
+ * The command only moves this axis of the address pointer back to the start,
+ * so unless the pointer already was at the start of the window its position is lost.
+ */
+static bool SetWindowAxis( struct SSD1306_Device* DeviceHandle, SSDCmd Command, int* ShadowStart, int* ShadowEnd, uint8_t Start, uint8_t End, bool Force ) {
+    uint8_t Commands[ 3 ];
+
+    if ( Force == false && *ShadowStart == Start && *ShadowEnd == End ) {
+        return true;
+    }
+
+    Commands[ 0 ] = Command;
+    Commands[ 1 ] = Start;
+    Commands[ 2 ] = End;
+
+    if ( WriteCommandSequence( DeviceHandle, Commands, sizeof( Commands ) ) == false ) {
+        *ShadowStart = SSD1306_State_Unknown;
+        *ShadowEnd = SSD1306_State_Unknown;
+
+        DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+        return false;
+    }
+
+    *ShadowStart = Start;
+    *ShadowEnd = End;
+
+    if ( DeviceHandle->State.WindowFill != 0 ) {
+        DeviceHandle->State.WindowFill = SSD1306_State_Unknown;
+    }
+
+    return true;
+}
+
+void SSD1306_SetColumnAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End ) {
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Display_Off );
+
+    CheckBounds( ( DeviceHandle->Controller->AddressModes & BIT( AddressMode_Horizontal ) ) == 0, return );
+    CheckBounds( Start >= DeviceHandle->Controller->RAMColumns, return );
+    CheckBounds( End >= DeviceHandle->Controller->RAMColumns, return );
+
+    SetWindowAxis( DeviceHandle, SSDCmd_Set_Column_Address, &DeviceHandle->State.ColumnStart, &DeviceHandle->State.ColumnEnd, Start, End, DeviceHandle->State.WindowFill != 0 );
 }
 
-void SSD1306_SetDisplayAddressMode( struct SSD1306_Device* DeviceHandle, SSD1306_AddressMode AddressMode ) {
+void SSD1306_SetPageAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End ) {
     NullCheck( DeviceHandle, return );
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Memory_Addressing_Mode );
-    SSD1306_WriteCommand( DeviceHandle, AddressMode );
+    CheckBounds( ( DeviceHandle->Controller->AddressModes & BIT( AddressMode_Horizontal ) ) == 0, return );
+    CheckBounds( Start > SSD1306_Max_Row, return );
+    CheckBounds( End > SSD1306_Max_Row, return );
+
+    SetWindowAxis( DeviceHandle, SSDCmd_Set_Page_Address, &DeviceHandle->State.PageStart, &DeviceHandle->State.PageEnd, Start, End, DeviceHandle->State.WindowFill != 0 );
+}
+
+/*
+ * Sets the whole window in horizontal or vertical mode.
+ * Whether it has to be sent again is decided once for both axes, as each
+ * command only moves its own half of the address pointer back to the start.
+ */
+static void SetWindow( struct SSD1306_Device* DeviceHandle, int Left, int Right, int StartPage, int EndPage ) {
+    bool Resend = ( DeviceHandle->State.WindowFill != 0 ) ? true : false;
+    bool Sent = false;
+
+    Sent = SetWindowAxis( DeviceHandle, SSDCmd_Set_Column_Address, &DeviceHandle->State.ColumnStart, &DeviceHandle->State.ColumnEnd, Left, Right, Resend );
+    Sent = SetWindowAxis( DeviceHandle, SSDCmd_Set_Page_Address, &DeviceHandle->State.PageStart, &DeviceHandle->State.PageEnd, StartPage, EndPage, Resend ) && Sent;
+
+    DeviceHandle->State.WindowFill = ( Sent == true ) ? 0 : SSD1306_State_Unknown;
+}
+
+/*
+ * Page addressing only knows where a page starts, so every page is its own transfer.
+ */
+static void WritePages( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, int Left, int Right, int StartPage, int EndPage ) {
+    uint8_t Commands[ 3 ];
+    int Column = Left + DeviceHandle->Controller->ColumnOffset;
+    int Page = 0;
+
+    for ( Page = StartPage; Page <= EndPage; Page++, Data+= DeviceHandle->Screen.BytesPerPage ) {
+        Commands[ 0 ] = SSDCmd_Set_Page_Start | Page;
+        Commands[ 1 ] = SSDCmd_Set_Lower_Column_Start | ( Column & 0x0F );
+        Commands[ 2 ] = SSDCmd_Set_Higher_Column_Start | ( ( Column >> 4 ) & 0x0F );
+
+        if ( WriteCommandSequence( DeviceHandle, Commands, sizeof( Commands ) ) == true ) {
+            SSD1306_WriteData( DeviceHandle, ( uint8_t* ) &Data[ Left ], ( Right - Left ) + 1 );
+        }
+    }
+}
+
+/*
+ * 4bpp controllers address rows and pairs of columns instead of pages.
+ */
+static bool SetGrayWindow( struct SSD1306_Device* DeviceHandle, int Left, int Right, int Top, int Bottom ) {
+    uint8_t Commands[ 6 ];
+
+    Commands[ 0 ] = SSDCmd_Set_Gray_Column_Address;
+    Commands[ 1 ] = ( Left + DeviceHandle->Controller->ColumnOffset ) / 2;
+    Commands[ 2 ] = ( Right + DeviceHandle->Controller->ColumnOffset ) / 2;
+    Commands[ 3 ] = SSDCmd_Set_Gray_Row_Address;
+    Commands[ 4 ] = Top;
+    Commands[ 5 ] = Bottom;
+
+    return WriteCommandSequence( DeviceHandle, Commands, sizeof( Commands ) );
+}
+
+static void WriteGrayWindow( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, int Left, int Right, int StartPage, int EndPage ) {
+    int Pitch = DeviceHandle->Screen.Width / 2;
+    int Row = 0;
+
+    /* Both pixels of a byte always go out together */
+    Left&= ~0x01;
+    Right|= 0x01;
+
+    if ( SetGrayWindow( DeviceHandle, Left, Right, StartPage * 8, ( EndPage * 8 ) + 7 ) == false ) {
+        return;
+    }
+
+    if ( Left == 0 && Right == DeviceHandle->Screen.Width - 1 ) {
+        SSD1306_WriteData( DeviceHandle, ( uint8_t* ) Data, ( ( EndPage - StartPage ) + 1 ) * DeviceHandle->Screen.BytesPerPage );
+    } else {
+        for ( Row = 0; Row < ( ( EndPage - StartPage ) + 1 ) * 8; Row++, Data+= Pitch ) {
+            SSD1306_WriteData( DeviceHandle, ( uint8_t* ) &Data[ Left / 2 ], ( ( Right - Left ) + 1 ) / 2 );
+        }
+    }
+}
+
+/*
+ * Display RAM for these pages no longer matches the hashes of the last frame.
+ */
+static void ForgetPageHashes( struct SSD1306_Device* DeviceHandle, int StartPage, int EndPage ) {
+    DeviceHandle->PageHashValid&= ~( ( ( 1u << ( ( EndPage - StartPage ) + 1 ) ) - 1 ) << StartPage );
+}
+
+void SSD1306_WriteWindow( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, int Left, int Right, int StartPage, int EndPage ) {
+    int Offset = 0;
+    int Page = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( Data, return );
+
+    ForgetPageHashes( DeviceHandle, StartPage, EndPage );
+
+    if ( DeviceHandle->Screen.PixelFormat == PixelFormat_Gray4 ) {
+        WriteGrayWindow( DeviceHandle, Data, Left, Right, StartPage, EndPage );
+        return;
+    }
+
+    if ( HasAddressMode( DeviceHandle, AddressMode_Horizontal ) == false ) {
+        WritePages( DeviceHandle, Data, Left, Right, StartPage, EndPage );
+        return;
+    }
+
+    Offset = DeviceHandle->Controller->ColumnOffset;
+
+    SSD1306_SetDisplayAddressMode( DeviceHandle, AddressMode_Horizontal );
+    SetWindow( DeviceHandle, Left + Offset, Right + Offset, StartPage, EndPage );
+
+    /* Full width windows are contiguous in the buffer and go out in one transfer */
+    if ( Left == 0 && Right == DeviceHandle->Screen.Width - 1 ) {
+        SSD1306_WriteData( DeviceHandle, ( uint8_t* ) Data, ( ( EndPage - StartPage ) + 1 ) * DeviceHandle->Screen.Width );
+    } else {
+        for ( Page = StartPage; Page <= EndPage; Page++, Data+= DeviceHandle->Screen.BytesPerPage ) {
+            SSD1306_WriteData( DeviceHandle, ( uint8_t* ) &Data[ Left ], ( Right - Left ) + 1 );
+        }
+    }
+}
+
+/*
+ * MurmurHash3 over a page, a word at a time with the leftover bytes folded in last.
+ */
+static uint32_t HashPage( const uint8_t* Data, int Length ) {
+    uint32_t Hash = 0;
+    uint32_t Word = 0;
+    int i = 0;
+
+    for ( i = 0; i + 4 <= Length; i+= 4 ) {
+        /* Pages need not be word aligned, this still compiles to a single load */
+        memcpy( &Word, &Data[ i ], sizeof( Word ) );
+
+        Word*= 0xCC9E2D51;
+        Word = ( Word << 15 ) | ( Word >> 17 );
+        Word*= 0x1B873593;
+
+        Hash^= Word;
+        Hash = ( Hash << 13 ) | ( Hash >> 19 );
+        Hash = ( Hash * 5 ) + 0xE6546B64;
+    }
+
+    for ( Word = 0; i < Length; i++ ) {
+        Word = ( Word << 8 ) | Data[ i ];
+    }
+
+    Word*= 0xCC9E2D51;
+    Word = ( Word << 15 ) | ( Word >> 17 );
+    Word*= 0x1B873593;
+
+    Hash^= Word ^ ( uint32_t ) Length;
+    Hash^= Hash >> 16;
+    Hash*= 0x85EBCA6B;
+    Hash^= Hash >> 13;
+    Hash*= 0xC2B2AE35;
+    Hash^= Hash >> 16;
+
+    return Hash;
+}
+
+static bool IsPageSent( struct SSD1306_Device* DeviceHandle, int Page, uint32_t Hash ) {
+    return ( ( DeviceHandle->PageHashValid & ( 1u << Page ) ) != 0 && DeviceHandle->PageHashes[ Page ] == Hash ) ? true : false;
+}
+
+/*
+ * Sends the pages whose hash changed since they were last sent,
+ * consecutive ones go out together as one full width window.
+ */
+static void WriteChangedPages( struct SSD1306_Device* DeviceHandle, const uint8_t* Framebuffer ) {
+    uint32_t Hashes[ SSD1306_MAX_PAGES ];
+    int Pages = DeviceHandle->Screen.Height / 8;
+    int Start = 0;
+    int Page = 0;
+
+    for ( Page = 0; Page < Pages; Page++ ) {
+        Hashes[ Page ] = HashPage( &Framebuffer[ Page * DeviceHandle->Screen.BytesPerPage ], DeviceHandle->Screen.BytesPerPage );
+    }
+
+    for ( Page = 0; Page < Pages; ) {
+        if ( IsPageSent( DeviceHandle, Page, Hashes[ Page ] ) == true ) {
+            Page++;
+            continue;
+        }
+
+        Start = Page;
+
+        while ( Page < Pages && IsPageSent( DeviceHandle, Page, Hashes[ Page ] ) == false ) {
+            Page++;
+        }
+
+        SSD1306_WriteWindow( DeviceHandle, &Framebuffer[ Start * DeviceHandle->Screen.BytesPerPage ], 0, DeviceHandle->Screen.Width - 1, Start, Page - 1 );
+
+        for ( ; Start < Page; Start++ ) {
+            DeviceHandle->PageHashes[ Start ] = Hashes[ Start ];
+            DeviceHandle->PageHashValid|= 1u << Start;
+        }
+    }
+}
+
+/*
+ * Sends a whole frame, when the previous transfer did the same no commands are needed.
+ */
+static void WriteFrame( struct SSD1306_Device* DeviceHandle, const uint8_t* Framebuffer ) {
+    if ( DeviceHandle->PageHashing == true ) {
+        WriteChangedPages( DeviceHandle, Framebuffer );
+        return;
+    }
+
+    SSD1306_WriteWindow( DeviceHandle, Framebuffer, 0, DeviceHandle->Screen.Width - 1, 0, ( DeviceHandle->Screen.Height / 8 ) - 1 );
+}
+
+void SSD1306_SetPageHashing( struct SSD1306_Device* DeviceHandle, bool On ) {
+    NullCheck( DeviceHandle, return );
+
+    /* Nothing is known to have been sent yet, the first frame goes out whole */
+    DeviceHandle->PageHashing = On;
+    DeviceHandle->PageHashValid = 0;
+}
+
+uint8_t* SSD1306_GetScreenFramebuffer( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return NULL );
+
+    /* It is kept in Screen while drawing goes into a canvas */
+    return ( DeviceHandle->Target != NULL ) ? DeviceHandle->Screen.Framebuffer : DeviceHandle->Framebuffer;
 }
 
 void SSD1306_Update( struct SSD1306_Device* DeviceHandle ) {
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteData( DeviceHandle, DeviceHandle->Framebuffer, DeviceHandle->FramebufferSize );
+
+    if ( DeviceHandle->StripPages > 0 ) {
+        SSD1306_StripUpdate( DeviceHandle );
+        return;
+    }
+
+    WriteFrame( DeviceHandle, SSD1306_GetScreenFramebuffer( DeviceHandle ) );
 }
 
-void SSD1306_WriteRawData( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength ) {
+/*
+ * Clips Region to the screen and returns the columns and pages it covers,
+ * false if the region is entirely offscreen.
+ */
+static bool GetRegionSpan( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region, int* OutLeft, int* OutRight, int* OutStartPage, int* OutEndPage ) {
+    /* Dividing would round rows -7 to -1 up into page 0 */
+    if ( Region->Bottom < 0 || Region->Right < 0 ) {
+        return false;
+    }
+
+    *OutLeft = ( Region->Left < 0 ) ? 0 : Region->Left;
+    *OutRight = ( Region->Right >= DeviceHandle->Screen.Width ) ? DeviceHandle->Screen.Width - 1 : Region->Right;
+    *OutStartPage = ( Region->Top < 0 ) ? 0 : Region->Top / 8;
+    *OutEndPage = ( Region->Bottom >= DeviceHandle->Screen.Height ) ? ( DeviceHandle->Screen.Height / 8 ) - 1 : Region->Bottom / 8;
+
+    return ( *OutLeft <= *OutRight && *OutStartPage <= *OutEndPage ) ? true : false;
+}
+
+/*
+ * Tall and narrow windows would take one transfer per page in horizontal mode.
+ * Instead the bytes are gathered column by column and sent in vertical mode as one transfer.
+ */
+static bool WriteVerticalWindow( struct SSD1306_Device* DeviceHandle, const uint8_t* Framebuffer, int Left, int Right, int StartPage, int EndPage ) {
+    uint8_t* Stage = NULL;
+    int Column = 0;
+    int Page = 0;
+
+    if ( DeviceHandle->StagingBuffer == NULL ) {
+        DeviceHandle->StagingBuffer = SSD1306_AllocFramebuffer( ( DeviceHandle->Screen.Height / 8 ) * SSD1306_VERTICAL_STAGE_COLUMNS );
+
+        if ( DeviceHandle->StagingBuffer == NULL ) {
+            return false;
+        }
+    }
+
+    for ( Stage = DeviceHandle->StagingBuffer, Column = Left; Column <= Right; Column++ ) {
+        for ( Page = StartPage; Page <= EndPage; Page++ ) {
+            *Stage++ = Framebuffer[ ( Page * DeviceHandle->Screen.BytesPerPage ) + Column ];
+        }
+    }
+
+    ForgetPageHashes( DeviceHandle, StartPage, EndPage );
+
+    SSD1306_SetDisplayAddressMode( DeviceHandle, AddressMode_Vertical );
+    SetWindow( DeviceHandle, Left + DeviceHandle->Controller->ColumnOffset, Right + DeviceHandle->Controller->ColumnOffset, StartPage, EndPage );
+
+    SSD1306_WriteData( DeviceHandle, DeviceHandle->StagingBuffer, Stage - DeviceHandle->StagingBuffer );
+
+    /* Callers setting a window themselves with SSD1306_SetColumnAddress expect horizontal mode */
+    SSD1306_SetDisplayAddressMode( DeviceHandle, AddressMode_Horizontal );
+
+    return true;
+}
+
+
+/*
+ * Sends only the part of Framebuffer covered by Region.
+ * The region is widened to whole pages since that is what the display addresses.
+ */
+void SSD1306_UpdateRegionFrom( struct SSD1306_Device* DeviceHandle, const uint8_t* Framebuffer, const struct SSD1306_Rect* Region ) {
+    int StartPage = 0;
+    int EndPage = 0;
+    int Left = 0;
+    int Right = 0;
+
     NullCheck( DeviceHandle, return );
-    NullCheck( Data, return );
+    NullCheck( Framebuffer, return );
+    NullCheck( Region, return );
 
-    DataLength = DataLength > DeviceHandle->FramebufferSize ? DeviceHandle->FramebufferSize : DataLength;
+    if ( GetRegionSpan( DeviceHandle, Region, &Left, &Right, &StartPage, &EndPage ) == false ) {
+        return;
+    }
 
-    if ( DataLength > 0 ) {
-        SSD1306_WriteData( DeviceHandle, Data, DataLength );
+    /* The whole frame can go out in one transfer */
+    if ( Left == 0 && Right == DeviceHandle->Screen.Width - 1 && StartPage == 0 && EndPage == ( DeviceHandle->Screen.Height / 8 ) - 1 ) {
+        WriteFrame( DeviceHandle, Framebuffer );
+        return;
+    }
+
+    if ( HasAddressMode( DeviceHandle, AddressMode_Vertical ) && ( ( EndPage - StartPage ) + 1 ) * 8 > ( Right - Left ) + 1 && ( Right - Left ) < SSD1306_VERTICAL_STAGE_COLUMNS ) {
+        if ( WriteVerticalWindow( DeviceHandle, Framebuffer, Left, Right, StartPage, EndPage ) == true ) {
+            return;
+        }
     }
+
+    SSD1306_WriteWindow( DeviceHandle, &Framebuffer[ StartPage * DeviceHandle->Screen.BytesPerPage ], Left, Right, StartPage, EndPage );
 }
 
-void SSD1306_SetHFlip( struct SSD1306_Device* DeviceHandle, bool On ) {
+void SSD1306_UpdateRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region ) {
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, ( On == true ) ? SSDCmd_Set_Display_HFlip_On : SSDCmd_Set_Display_HFlip_Off );
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    if ( DeviceHandle->StripPages > 0 ) {
+        SSD1306_Update( DeviceHandle );
+        return;
+    }
+
+    SSD1306_UpdateRegionFrom( DeviceHandle, SSD1306_GetScreenFramebuffer( DeviceHandle ), Region );
 }
 
-void SSD1306_SetVFlip( struct SSD1306_Device* DeviceHandle, bool On ) {
+/*
+ * Maps the n-th step of an interlaced frame to the page sent during it.
+ */
+static int GetInterlacedPage( SSD1306_InterlaceMode Mode, int Pages, int Step ) {
+    int Half = ( Pages + 1 ) / 2;
+
+    if ( Mode == Interlace_EvenOdd ) {
+        return ( Step < Half ) ? Step * 2 : ( ( Step - Half ) * 2 ) + 1;
+    }
+
+    return Step;
+}
+
+void SSD1306_UpdateInterlaced( struct SSD1306_Device* DeviceHandle, SSD1306_InterlaceMode Mode, int PagesPerCall ) {
+    uint8_t* Framebuffer = NULL;
+    int Pages = 0;
+    int Page = 0;
+    int Count = 0;
+    int i = 0;
+
     NullCheck( DeviceHandle, return );
-    SSD1306_WriteCommand( DeviceHandle, ( On == true ) ? SSDCmd_Set_Display_VFlip_On : SSDCmd_Set_Display_VFlip_Off );
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    CheckBounds( PagesPerCall < 1, return );
+    CheckBounds( DeviceHandle->StripPages > 0, return );
+
+    Framebuffer = SSD1306_GetScreenFramebuffer( DeviceHandle );
+    Pages = DeviceHandle->Screen.Height / 8;
+
+    /* The previous call finished a frame, this one starts the next */
+    if ( DeviceHandle->InterlaceStep >= Pages ) {
+        DeviceHandle->InterlaceStep = 0;
+    }
+
+    Count = ( PagesPerCall > Pages - DeviceHandle->InterlaceStep ) ? Pages - DeviceHandle->InterlaceStep : PagesPerCall;
+
+    if ( Mode == Interlace_RoundRobin ) {
+        /* Consecutive full width pages fit in a single window */
+        Page = DeviceHandle->InterlaceStep;
+        SSD1306_WriteWindow( DeviceHandle, &Framebuffer[ Page * DeviceHandle->Screen.BytesPerPage ], 0, DeviceHandle->Screen.Width - 1, Page, Page + Count - 1 );
+    } else {
+        for ( i = 0; i < Count; i++ ) {
+            Page = GetInterlacedPage( Mode, Pages, DeviceHandle->InterlaceStep + i );
+            SSD1306_WriteWindow( DeviceHandle, &Framebuffer[ Page * DeviceHandle->Screen.BytesPerPage ], 0, DeviceHandle->Screen.Width - 1, Page, Page );
+        }
+    }
+
+    DeviceHandle->InterlaceStep+= Count;
 }
 
-void SSD1306_SetColumnAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End ) {
+bool SSD1306_IsFrameComplete( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return true );
+    return ( DeviceHandle->InterlaceStep >= ( DeviceHandle->Screen.Height / 8 ) ) ? true : false;
+}
+
+uint8_t* SSD1306_AllocFramebuffer( int Size ) {
+    return heap_caps_calloc( 1, Size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT );
+}
+
+void SSD1306_FreeFramebuffer( uint8_t* Framebuffer ) {
+    if ( Framebuffer != NULL ) {
+        heap_caps_free( Framebuffer );
+    }
+}
+
+bool SSD1306_EnableDoubleBuffering( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckState( DeviceHandle->StripPages > 0, return false );
+    CheckState( DeviceHandle->Target != NULL, return false );
+
+    if ( DeviceHandle->FrontBuffer == NULL ) {
+        NullCheck( ( DeviceHandle->FrontBuffer = SSD1306_AllocFramebuffer( DeviceHandle->FramebufferSize ) ), return false );
+
+        /* Whatever was last sent is the front buffer as far as the display is concerned */
+        memcpy( DeviceHandle->FrontBuffer, DeviceHandle->Framebuffer, DeviceHandle->FramebufferSize );
+    }
+
+    return true;
+}
+
+void SSD1306_DisableDoubleBuffering( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return );
+
+    SSD1306_FreeFramebuffer( DeviceHandle->FrontBuffer );
+    DeviceHandle->FrontBuffer = NULL;
+}
+
+void SSD1306_CopyFrontToBackRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region ) {
+    int StartPage = 0;
+    int EndPage = 0;
+    int Offset = 0;
+    int Left = 0;
+    int Right = 0;
+    int Page = 0;
+    int Row = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->FrontBuffer, return );
+    NullCheck( Region, return );
+
+    CheckState( DeviceHandle->Target != NULL, return );
+
+    if ( GetRegionSpan( DeviceHandle, Region, &Left, &Right, &StartPage, &EndPage ) == false ) {
+        return;
+    }
+
+    if ( DeviceHandle->Screen.PixelFormat == PixelFormat_Gray4 ) {
+        /* Rows of whole bytes, so pairs of columns */
+        for ( Row = StartPage * 8; Row <= ( EndPage * 8 ) + 7; Row++ ) {
+            Offset = ( Row * ( DeviceHandle->Screen.Width / 2 ) ) + ( Left / 2 );
+            memcpy( &DeviceHandle->Framebuffer[ Offset ], &DeviceHandle->FrontBuffer[ Offset ], ( Right / 2 ) - ( Left / 2 ) + 1 );
+        }
+    } else {
+        for ( Page = StartPage; Page <= EndPage; Page++ ) {
+            Offset = ( Page * DeviceHandle->Screen.BytesPerPage ) + Left;
+            memcpy( &DeviceHandle->Framebuffer[ Offset ], &DeviceHandle->FrontBuffer[ Offset ], ( Right - Left ) + 1 );
+        }
+    }
+}
+
+void SSD1306_CopyFrontToBack( struct SSD1306_Device* DeviceHandle ) {
     NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->FrontBuffer, return );
 
-    CheckBounds( Start > SSD1306_Max_Col, return );
-    CheckBounds( End > SSD1306_Max_Col, return );
+    CheckState( DeviceHandle->Target != NULL, return );
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Column_Address );
-    SSD1306_WriteCommand( DeviceHandle, Start );
-    SSD1306_WriteCommand( DeviceHandle, End );
+    memcpy( DeviceHandle->Framebuffer, DeviceHandle->FrontBuffer, DeviceHandle->FramebufferSize );
 }
 
-void SSD1306_SetPageAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End ) {
+static void SwapBuffers( struct SSD1306_Device* DeviceHandle ) {
+    uint8_t* Temp = DeviceHandle->FrontBuffer;
+
+    DeviceHandle->FrontBuffer = DeviceHandle->Framebuffer;
+    DeviceHandle->Framebuffer = Temp;
+}
+
+void SSD1306_Present( struct SSD1306_Device* DeviceHandle, SSD1306_PresentMode Mode ) {
     NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->FrontBuffer, return );
 
-    CheckBounds( Start > SSD1306_Max_Row, return );
-    CheckBounds( End > SSD1306_Max_Row, return );
+    CheckState( DeviceHandle->Target != NULL, return );
+
+    SwapBuffers( DeviceHandle );
+
+    /* The copy happens before the transfer so the caller can start drawing as soon as we return */
+    if ( Mode == Present_Copy ) {
+        SSD1306_CopyFrontToBack( DeviceHandle );
+    }
+
+    WriteFrame( DeviceHandle, DeviceHandle->FrontBuffer );
+}
+
+void SSD1306_PresentRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region, SSD1306_PresentMode Mode ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->FrontBuffer, return );
+    NullCheck( Region, return );
+
+    CheckState( DeviceHandle->Target != NULL, return );
+
+    SwapBuffers( DeviceHandle );
+
+    /* Only the region changed, so only the region needs carrying forward */
+    if ( Mode == Present_Copy ) {
+        SSD1306_CopyFrontToBackRegion( DeviceHandle, Region );
+    }
+
+    SSD1306_UpdateRegionFrom( DeviceHandle, DeviceHandle->FrontBuffer, Region );
+}
+
+/*
+ * Raw data starts at the top left of the screen but may end anywhere.
+ */
+static void WriteRaw( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength ) {
+    size_t Length = 0;
+    int Page = 0;
+
+    ForgetPageHashes( DeviceHandle, 0, ( DeviceHandle->Screen.Height / 8 ) - 1 );
+
+    if ( DeviceHandle->Screen.PixelFormat == PixelFormat_Gray4 ) {
+        if ( SetGrayWindow( DeviceHandle, 0, DeviceHandle->Screen.Width - 1, 0, DeviceHandle->Screen.Height - 1 ) == true ) {
+            SSD1306_WriteData( DeviceHandle, Data, DataLength );
+        }
+
+        return;
+    }
+
+    if ( HasAddressMode( DeviceHandle, AddressMode_Horizontal ) == true ) {
+        SSD1306_SetDisplayAddressMode( DeviceHandle, AddressMode_Horizontal );
+        SetWindow( DeviceHandle, DeviceHandle->Controller->ColumnOffset, DeviceHandle->Controller->ColumnOffset + DeviceHandle->Screen.Width - 1, 0, ( DeviceHandle->Screen.Height / 8 ) - 1 );
+        SSD1306_WriteData( DeviceHandle, Data, DataLength );
+
+        return;
+    }
+
+    for ( Page = 0; DataLength > 0; Page++ ) {
+        Length = ( DataLength > ( size_t ) DeviceHandle->Screen.Width ) ? ( size_t ) DeviceHandle->Screen.Width : DataLength;
+        WritePages( DeviceHandle, Data, 0, Length - 1, Page, Page );
+
+        Data+= Length;
+        DataLength-= Length;
+    }
+}
 
-    SSD1306_WriteCommand( DeviceHandle, SSDCmd_Set_Page_Address );
-    SSD1306_WriteCommand( DeviceHandle, Start );
-    SSD1306_WriteCommand( DeviceHandle, End );
+void SSD1306_WriteRawData( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( Data, return );
+
+    DataLength = DataLength > ( size_t ) DeviceHandle->FramebufferSize ? ( size_t ) DeviceHandle->FramebufferSize : DataLength;
+
+    if ( DataLength > 0 ) {
+        WriteRaw( DeviceHandle, Data, DataLength );
+    }
+}
+
+void SSD1306_SetHFlip( struct SSD1306_Device* DeviceHandle, bool On ) {
+    const uint8_t Command = ( On == true ) ? SSDCmd_Set_Display_HFlip_On : SSDCmd_Set_Display_HFlip_Off;
+
+    NullCheck( DeviceHandle, return );
+
+    /* Grayscale controllers remap through a different command, the current target does not matter */
+    CheckState( DeviceHandle->Controller->PixelFormat != PixelFormat_Mono, return );
+
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.HFlip, On, &Command, 1 );
+}
+
+void SSD1306_SetVFlip( struct SSD1306_Device* DeviceHandle, bool On ) {
+    const uint8_t Command = ( On == true ) ? SSDCmd_Set_Display_VFlip_On : SSDCmd_Set_Display_VFlip_Off;
+
+    NullCheck( DeviceHandle, return );
+
+    /* Grayscale controllers remap through a different command, the current target does not matter */
+    CheckState( DeviceHandle->Controller->PixelFormat != PixelFormat_Mono, return );
+
+    WriteShadowed( DeviceHandle, &DeviceHandle->State.VFlip, On, &Command, 1 );
 }
 
 bool SSD1306_HWReset( struct SSD1306_Device* DeviceHandle ) {
     NullCheck( DeviceHandle, return 0 );
 
     if ( DeviceHandle->Reset != NULL ) {
+        /* Whatever the controller had before is gone now */
+        SSD1306_InvalidateState( DeviceHandle );
+
         return ( DeviceHandle->Reset ) ( DeviceHandle );
     }
 
@@ -195,47 +899,186 @@ bool SSD1306_HWReset( struct SSD1306_Device* DeviceHandle ) {
     return true;
 }
 
+/*
+ * Sends the init sequence for the panel's geometry in one go and records
+ * the state it leaves the controller in. The display is left off.
+ */
+static bool WriteInitSequence( struct SSD1306_Device* DeviceHandle ) {
+    const struct SSD1306_InitSequence* Sequence = NULL;
+    uint8_t Commands[ SSD1306_MAX_INIT_SEQUENCE ];
+
+    NullCheck( ( Sequence = SSD1306_GetInitSequence( DeviceHandle->Controller, DeviceHandle->Screen.Height ) ), return false );
+    CheckBounds( Sequence->Length > sizeof( Commands ), return false );
+
+    /* Copied so the interface never has to DMA out of flash */
+    memcpy( Commands, Sequence->Commands, Sequence->Length );
+    Commands[ SSD1306_INIT_SEQUENCE_MUX_RATIO ] = ( uint8_t ) ( DeviceHandle->Screen.Height - 1 );
+
+    if ( WriteCommandSequence( DeviceHandle, Commands, Sequence->Length ) == false ) {
+        SSD1306_InvalidateState( DeviceHandle );
+        return false;
+    }
+
+    DeviceHandle->State.Contrast = 0x7F;
+    DeviceHandle->State.Inverted = false;
+    DeviceHandle->State.HFlip = ( DeviceHandle->Screen.PixelFormat == PixelFormat_Mono ) ? false : SSD1306_State_Unknown;
+    DeviceHandle->State.VFlip = ( DeviceHandle->Screen.PixelFormat == PixelFormat_Mono ) ? false : SSD1306_State_Unknown;
+    DeviceHandle->State.AddressMode = HasAddressMode( DeviceHandle, AddressMode_Horizontal ) ? AddressMode_Horizontal : AddressMode_Page;
+    DeviceHandle->State.DisplayOn = false;
+    DeviceHandle->State.ShowRAM = true;
+    DeviceHandle->State.StartLine = 0;
+
+    return true;
+}
+
+/*
+ * Resets and initializes the controller, then clears display RAM before switching the panel on.
+ */
+static bool StartController( struct SSD1306_Device* DeviceHandle ) {
+    /* Nothing is known about the controller until the init sequence went out */
+    SSD1306_InvalidateState( DeviceHandle );
+
+    /* For those who have a hardware reset pin on their display */
+    SSD1306_HWReset( DeviceHandle );
+
+    if ( WriteInitSequence( DeviceHandle ) == false ) {
+        return false;
+    }
+
+    /* Whatever display RAM held never shows */
+    SSD1306_Update( DeviceHandle );
+    SSD1306_DisplayOn( DeviceHandle );
+
+    return true;
+}
+
+/*
+ * Checks the panel fits the controller and sets up the framebuffer layout it uses.
+ * The framebuffer is (re)allocated if its size changes.
+ */
+static bool SetupFramebuffer( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Controller* Controller ) {
+    const struct SSD1306_PixelOps* PixelOps = NULL;
+    uint8_t* Framebuffer = NULL;
+    int Size = 0;
+
+    NullCheck( ( PixelOps = SSD1306_GetPixelOps( Controller->PixelFormat ) ), return false );
+
+    CheckBounds( DeviceHandle->Width < 1 || DeviceHandle->Width > Controller->RAMColumns - Controller->ColumnOffset, return false );
+    CheckBounds( DeviceHandle->Height < 8 || DeviceHandle->Height > Controller->MaxHeight || ( DeviceHandle->Height % 8 ) != 0, return false );
+    CheckBounds( PixelOps->Depth > 1 && ( DeviceHandle->Width % 2 ) != 0, return false );
+
+    Size = ( DeviceHandle->Width * DeviceHandle->Height * PixelOps->Depth ) / 8;
+
+    if ( DeviceHandle->Framebuffer == NULL || Size != DeviceHandle->FramebufferSize ) {
+        NullCheck( ( Framebuffer = SSD1306_AllocFramebuffer( Size ) ), return false );
+
+        SSD1306_FreeFramebuffer( DeviceHandle->Framebuffer );
+        DeviceHandle->Framebuffer = Framebuffer;
+    }
+
+    DeviceHandle->Controller = Controller;
+    DeviceHandle->PixelFormat = Controller->PixelFormat;
+    DeviceHandle->PixelOps = PixelOps;
+    DeviceHandle->BytesPerPage = DeviceHandle->Width * PixelOps->Depth;
+    DeviceHandle->FramebufferSize = Size;
+    DeviceHandle->FramebufferPage = 0;
+    DeviceHandle->FramebufferPages = DeviceHandle->Height / 8;
+
+    /* Transfers and background tasks go by these, drawing into a canvas never changes them */
+    DeviceHandle->Screen.Width = DeviceHandle->Width;
+    DeviceHandle->Screen.Height = DeviceHandle->Height;
+    DeviceHandle->Screen.BytesPerPage = DeviceHandle->BytesPerPage;
+    DeviceHandle->Screen.PixelFormat = DeviceHandle->PixelFormat;
+
+    DeviceHandle->Clip.Left = 0;
+    DeviceHandle->Clip.Top = 0;
+    DeviceHandle->Clip.Right = DeviceHandle->Width - 1;
+    DeviceHandle->Clip.Bottom = DeviceHandle->Height - 1;
+
+    return true;
+}
+
+bool SSD1306_SetController( struct SSD1306_Device* DeviceHandle, SSD1306_ControllerType Type ) {
+    const struct SSD1306_Controller* Controller = NULL;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+    NullCheck( ( Controller = SSD1306_GetController( Type ) ), return false );
+
+    CheckState( DeviceHandle->Target != NULL, return false );
+
+    /* Other buffers sized for the old pixel format would be left behind */
+    CheckBounds( Controller->PixelFormat != DeviceHandle->PixelFormat && ( DeviceHandle->FrontBuffer != NULL || DeviceHandle->StripPages > 0 ), return false );
+
+    if ( SetupFramebuffer( DeviceHandle, Controller ) == false ) {
+        return false;
+    }
+
+    return StartController( DeviceHandle );
+}
+
 static bool SSD1306_Init( struct SSD1306_Device* DeviceHandle, int Width, int Height ) {
+    const struct SSD1306_Controller* Controller = NULL;
+
+    NullCheck( ( Controller = SSD1306_GetController( DefaultController ) ), return false );
+
     DeviceHandle->Width = Width;
     DeviceHandle->Height = Height;
-    DeviceHandle->FramebufferSize = ( DeviceHandle->Width * Height ) / 8;
 
-    DeviceHandle->Framebuffer = heap_caps_calloc( 1, DeviceHandle->FramebufferSize, MALLOC_CAP_DMA | MALLOC_CAP_8BIT );
+    if ( SetupFramebuffer( DeviceHandle, Controller ) == false ) {
+        return false;
+    }
+
+    return StartController( DeviceHandle );
+}
+
+bool SSD1306_WarmInit( struct SSD1306_Device* DeviceHandle ) {
+    struct SSD1306_ControllerState Previous;
 
+    NullCheck( DeviceHandle, return false );
     NullCheck( DeviceHandle->Framebuffer, return false );
 
-    /* For those who have a hardware reset pin on their display */
-    SSD1306_HWReset( DeviceHandle );
-    
-    /* Init sequence according to SSD1306.pdf */
-    SSD1306_SetMuxRatio( DeviceHandle, 0x3F );
-    SSD1306_SetDisplayOffset( DeviceHandle, 0x00 );
-    SSD1306_SetDisplayStartLine( DeviceHandle, 0 );
-    SSD1306_SetHFlip( DeviceHandle, false );
-    SSD1306_SetVFlip( DeviceHandle, false );
-
-    if ( Height == 64 ) {
-        SetCOMPinConfiguration( DeviceHandle, COM_Disable_LR_Remap, COM_Pins_Alternative, COM_ScanDir_LR );
-    } else {
-        SetCOMPinConfiguration( DeviceHandle, COM_Disable_LR_Remap, COM_Pins_Sequential, COM_ScanDir_LR );
+    Previous = DeviceHandle->State;
+    SSD1306_InvalidateState( DeviceHandle );
+
+    if ( WriteInitSequence( DeviceHandle ) == false ) {
+        return false;
+    }
+
+    /* Only settings that differ from the init sequence's defaults go out again */
+    if ( Previous.Contrast != SSD1306_State_Unknown ) {
+        SSD1306_SetContrast( DeviceHandle, ( uint8_t ) Previous.Contrast );
+    }
+
+    if ( Previous.Inverted != SSD1306_State_Unknown ) {
+        SSD1306_SetInverted( DeviceHandle, Previous.Inverted );
+    }
+
+    if ( Previous.HFlip != SSD1306_State_Unknown ) {
+        SSD1306_SetHFlip( DeviceHandle, Previous.HFlip );
+    }
+
+    if ( Previous.VFlip != SSD1306_State_Unknown ) {
+        SSD1306_SetVFlip( DeviceHandle, Previous.VFlip );
+    }
+
+    if ( Previous.StartLine != SSD1306_State_Unknown ) {
+        SSD1306_SetDisplayStartLine( DeviceHandle, Previous.StartLine );
+    }
+
+    /* A panel in an unknown state stays off, as it is after init */
+    if ( Previous.DisplayOn == true ) {
+        SSD1306_DisplayOn( DeviceHandle );
     }
-    
-    SSD1306_SetContrast( DeviceHandle, 0x7F );
-    SSD1306_DisableDisplayRAM( DeviceHandle );
-    SSD1306_SetInverted( DeviceHandle, false );
-    SSD1306_SetDisplayClocks( DeviceHandle, 0, 8 );
-    EnableChargePumpRegulator( DeviceHandle );
-    SSD1306_SetDisplayAddressMode( DeviceHandle, AddressMode_Horizontal );
-    SSD1306_SetColumnAddress( DeviceHandle, 0, DeviceHandle->Width - 1 );
-    SSD1306_SetPageAddress( DeviceHandle, 0, ( DeviceHandle->Height / 8 ) - 1 );
-    SSD1306_EnableDisplayRAM( DeviceHandle );
-    SSD1306_DisplayOn( DeviceHandle );
-    SSD1306_Update( DeviceHandle );
 
     return true;
 }
 
 bool SSD1306_Init_I2C( struct SSD1306_Device* DeviceHandle, int Width, int Height, int I2CAddress, int ResetPin, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset ) {
+    return SSD1306_Init_I2C_Ex( DeviceHandle, Width, Height, I2CAddress, ResetPin, WriteCommand, WriteData, Reset, NULL );
+}
+
+bool SSD1306_Init_I2C_Ex( struct SSD1306_Device* DeviceHandle, int Width, int Height, int I2CAddress, int ResetPin, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset, WriteCommandsProc WriteCommands ) {
     NullCheck( DeviceHandle, return false );
     NullCheck( WriteCommand, return false );
     NullCheck( WriteData, return false );
@@ -245,6 +1088,7 @@ bool SSD1306_Init_I2C( struct SSD1306_Device* DeviceHandle, int Width, int Heigh
     DeviceHandle->WriteCommand = WriteCommand;
     DeviceHandle->WriteData = WriteData;
     DeviceHandle->Reset = Reset;
+    DeviceHandle->WriteCommands = WriteCommands;
     DeviceHandle->Address = I2CAddress;
     DeviceHandle->RSTPin = ResetPin;
     
@@ -252,6 +1096,10 @@ bool SSD1306_Init_I2C( struct SSD1306_Device* DeviceHandle, int Width, int Heigh
 }
 
 bool SSD1306_Init_SPI( struct SSD1306_Device* DeviceHandle, int Width, int Height, int ResetPin, int CSPin, spi_device_handle_t SPIHandle, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset ) {
+    return SSD1306_Init_SPI_Ex( DeviceHandle, Width, Height, ResetPin, CSPin, SPIHandle, WriteCommand, WriteData, Reset, NULL );
+}
+
+bool SSD1306_Init_SPI_Ex( struct SSD1306_Device* DeviceHandle, int Width, int Height, int ResetPin, int CSPin, spi_device_handle_t SPIHandle, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset, WriteCommandsProc WriteCommands ) {
     NullCheck( DeviceHandle, return false );
     NullCheck( WriteCommand, return false );
     NullCheck( WriteData, return false );
@@ -261,6 +1109,7 @@ bool SSD1306_Init_SPI( struct SSD1306_Device* DeviceHandle, int Width, int Heigh
     DeviceHandle->WriteCommand = WriteCommand;
     DeviceHandle->WriteData = WriteData;
     DeviceHandle->Reset = Reset;
+    DeviceHandle->WriteCommands = WriteCommands;
     DeviceHandle->SPIHandle = SPIHandle;
     DeviceHandle->RSTPin = ResetPin;
     DeviceHandle->CSPin = CSPin;
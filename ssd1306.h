@@ -20,8 +20,20 @@ extern "C" {
 #define SSD1306_Max_Col 127
 #define SSD1306_Max_Row 7
 
+/* Most pages of 8 rows any supported panel has, 128 rows on 4bpp panels */
+#define SSD1306_MAX_PAGES 16
+
+/* Widest display RAM of any supported controller */
+#define SSD1306_MAX_COLUMNS 132
+
+/*
+ * Regions taller than they are wide and at most this many columns across
+ * are gathered into a staging buffer and sent in vertical addressing mode.
+ */
+#define SSD1306_VERTICAL_STAGE_COLUMNS 16
+
 #if ! defined BIT
-#define BIT( n ) ( 1 << n )
+#define BIT( n ) ( 1 << ( n ) )
 #endif
 
 typedef enum {
@@ -45,9 +57,44 @@ typedef enum {
     SSDCmd_Set_Display_CLK = 0xD5,
     SSDCmd_Enable_Charge_Pump_Regulator = 0x8D,
     SSDCmd_Set_Column_Address = 0x21,
-    SSDCmd_Set_Page_Address = 0x22
+    SSDCmd_Set_Page_Address = 0x22,
+    /* Page addressing mode, the low nibble or bits hold the page or column */
+    SSDCmd_Set_Lower_Column_Start = 0x00,
+    SSDCmd_Set_Higher_Column_Start = 0x10,
+    SSDCmd_Set_Page_Start = 0xB0,
+    /* SH1106 DC-DC control, SSD1305 master configuration */
+    SSDCmd_Set_DCDC = 0xAD,
+    /* SSD1327 window, columns are in units of two pixels */
+    SSDCmd_Set_Gray_Column_Address = 0x15,
+    SSDCmd_Set_Gray_Row_Address = 0x75,
+    /* SSD1327 setup, these take the place of the SSD1306 commands sharing their values */
+    SSDCmd_Set_Gray_Remap = 0xA0,
+    SSDCmd_Set_Gray_Start_Line = 0xA1,
+    SSDCmd_Set_Gray_Display_Offset = 0xA2,
+    SSDCmd_Set_Gray_Function_Select = 0xAB,
+    SSDCmd_Set_Gray_Phase_Length = 0xB1,
+    SSDCmd_Set_Gray_Display_CLK = 0xB3,
+    SSDCmd_Set_Gray_Second_Precharge = 0xB6,
+    SSDCmd_Set_Gray_Linear_Table = 0xB9,
+    SSDCmd_Set_Gray_Precharge_Voltage = 0xBC,
+    SSDCmd_Set_Gray_VCOMH = 0xBE,
+    SSDCmd_Set_Gray_Function_Select_B = 0xD5
 } SSDCmd;
 
+typedef enum {
+    /* The back buffer keeps whatever it held before, redraw everything */
+    Present_Discard = 0,
+    /* The presented frame is copied into the back buffer for incremental drawing */
+    Present_Copy
+} SSD1306_PresentMode;
+
+typedef enum {
+    /* Even pages first, then the odd ones */
+    Interlace_EvenOdd = 0,
+    /* Pages in order from top to bottom */
+    Interlace_RoundRobin
+} SSD1306_InterlaceMode;
+
 typedef enum {
     AddressMode_Horizontal = 0,
     AddressMode_Vertical,
@@ -55,8 +102,143 @@ typedef enum {
     AddressMode_Invalid
 } SSD1306_AddressMode;
 
+typedef enum {
+    Controller_SSD1306 = 0,
+    Controller_SH1106,
+    Controller_SSD1309,
+    Controller_SSD1305,
+    Controller_SSD1327
+} SSD1306_ControllerType;
+
+typedef enum {
+    /* 1bpp, each byte is a column of 8 pixels within a page */
+    PixelFormat_Mono = 0,
+    /* 4bpp grayscale, row major with the left pixel of each pair in the low nibble */
+    PixelFormat_Gray4,
+    /*
+     * 1bpp row major, each byte holds 8 pixels of a row with the leftmost in bit 0.
+     * Canvases only, horizontal spans and text touch far fewer bytes than in pages.
+     */
+    PixelFormat_MonoRow
+} SSD1306_PixelFormat;
+
 struct SSD1306_Device;
 
+/* Longest init sequence of any supported controller */
+#define SSD1306_MAX_INIT_SEQUENCE 32
+
+/* Every init sequence has the mux ratio argument at this offset */
+#define SSD1306_INIT_SEQUENCE_MUX_RATIO 4
+
+struct SSD1306_InitSequence {
+    /* Panel height the sequence was written for */
+    int Height;
+
+    const uint8_t* Commands;
+    size_t Length;
+};
+
+/*
+ * What sets the supported display controllers apart.
+ */
+struct SSD1306_Controller {
+    SSD1306_ControllerType Type;
+    const char* Name;
+
+    /* Columns of display RAM, and the RAM column shown in the leftmost pixel */
+    int RAMColumns;
+    int ColumnOffset;
+
+    /* BIT( AddressMode ) for each supported addressing mode */
+    uint8_t AddressModes;
+
+    SSD1306_PixelFormat PixelFormat;
+    int MaxHeight;
+
+    const struct SSD1306_InitSequence* InitSequences;
+    int InitSequenceCount;
+};
+
+/*
+ * Rectangle in display coordinates, all edges are inclusive.
+ */
+struct SSD1306_Rect {
+    int Left;
+    int Top;
+    int Right;
+    int Bottom;
+};
+
+static inline void SSD1306_RectSetEmpty( struct SSD1306_Rect* Rect ) {
+    Rect->Left = 0;
+    Rect->Top = 0;
+    Rect->Right = -1;
+    Rect->Bottom = -1;
+}
+
+static inline bool SSD1306_RectIsEmpty( const struct SSD1306_Rect* Rect ) {
+    return ( Rect->Right < Rect->Left || Rect->Bottom < Rect->Top ) ? true : false;
+}
+
+static inline bool SSD1306_RectIntersects( const struct SSD1306_Rect* a, const struct SSD1306_Rect* b ) {
+    return ( a->Left <= b->Right && a->Right >= b->Left && a->Top <= b->Bottom && a->Bottom >= b->Top ) ? true : false;
+}
+
+/*
+ * Grows Dest to include Rect, an empty Dest is replaced by Rect.
+ */
+static inline void SSD1306_RectUnion( struct SSD1306_Rect* Dest, const struct SSD1306_Rect* Rect ) {
+    if ( SSD1306_RectIsEmpty( Rect ) == true ) {
+        return;
+    }
+
+    if ( SSD1306_RectIsEmpty( Dest ) == true ) {
+        *Dest = *Rect;
+        return;
+    }
+
+    Dest->Left = ( Rect->Left < Dest->Left ) ? Rect->Left : Dest->Left;
+    Dest->Top = ( Rect->Top < Dest->Top ) ? Rect->Top : Dest->Top;
+    Dest->Right = ( Rect->Right > Dest->Right ) ? Rect->Right : Dest->Right;
+    Dest->Bottom = ( Rect->Bottom > Dest->Bottom ) ? Rect->Bottom : Dest->Bottom;
+}
+
+/*
+ * Shrinks Dest to the area it shares with Rect, which may leave it empty.
+ */
+static inline void SSD1306_RectIntersect( struct SSD1306_Rect* Dest, const struct SSD1306_Rect* Rect ) {
+    Dest->Left = ( Rect->Left > Dest->Left ) ? Rect->Left : Dest->Left;
+    Dest->Top = ( Rect->Top > Dest->Top ) ? Rect->Top : Dest->Top;
+    Dest->Right = ( Rect->Right < Dest->Right ) ? Rect->Right : Dest->Right;
+    Dest->Bottom = ( Rect->Bottom < Dest->Bottom ) ? Rect->Bottom : Dest->Bottom;
+}
+
+/*
+ * A surface to draw on, laid out like the framebuffer of a display using PixelFormat.
+ * The display's own framebuffer is one, see ssd1306_canvas.h for drawing into others.
+ */
+struct SSD1306_Canvas {
+    uint8_t* Framebuffer;
+
+    int Width;
+    int Height;
+
+    /* Bytes from one page to the next, more than Width needs when the canvas is a view into a wider one */
+    int BytesPerPage;
+
+    /* Range of pages held in Framebuffer, the display only holds some of them when strip rendering */
+    int FramebufferPage;
+    int FramebufferPages;
+
+    SSD1306_PixelFormat PixelFormat;
+
+    /* Drawing outside of Clip is ignored, it never extends past the canvas */
+    struct SSD1306_Rect Clip;
+
+    /* Framebuffer was allocated by SSD1306_CanvasInit and is freed with the canvas */
+    bool Owned;
+};
+
 /*
  * These can optionally return a succeed/fail but are as of yet unused in the driver.
  */
@@ -64,10 +246,47 @@ typedef bool ( *WriteCommandProc ) ( struct SSD1306_Device* DeviceHandle, SSDCmd
 typedef bool ( *WriteDataProc ) ( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, size_t DataLength );
 typedef bool ( *ResetProc ) ( struct SSD1306_Device* DeviceHandle );
 
+/*
+ * Optional, sends several command bytes in a single bus transaction.
+ * Commands is always in RAM so it may be handed straight to DMA.
+ */
+typedef bool ( *WriteCommandsProc ) ( struct SSD1306_Device* DeviceHandle, const uint8_t* Commands, size_t Length );
+
 struct spi_device_t;
 typedef struct spi_device_t* spi_device_handle_t;
 
 struct SSD1306_FontDef;
+struct SSD1306_DisplayList;
+struct SSD1306_PixelOps;
+
+#define SSD1306_State_Unknown -1
+
+/*
+ * Last values sent to the controller, SSD1306_State_Unknown until sent.
+ * Setters compare against these and skip commands that would change nothing.
+ */
+struct SSD1306_ControllerState {
+    int Contrast;
+    int Inverted;
+    int HFlip;
+    int VFlip;
+    int AddressMode;
+    int DisplayOn;
+    int ShowRAM;
+    int StartLine;
+
+    int ColumnStart;
+    int ColumnEnd;
+    int PageStart;
+    int PageEnd;
+
+    /*
+     * Bytes written into the current window modulo its size.
+     * The address pointer is only back at the start of the window when this is 0,
+     * otherwise setting the same window again is not redundant.
+     */
+    int WindowFill;
+};
 
 struct SSD1306_Device {
     /* I2C Specific */
@@ -82,43 +301,201 @@ struct SSD1306_Device {
     int Width;
     int Height;
 
+    /* Drawing always goes into Framebuffer, when double buffered this is the back buffer */
     uint8_t* Framebuffer;
     int FramebufferSize;
 
+    /*
+     * Layout of Framebuffer and the drawing kernels for it, set up from the controller.
+     * BytesPerPage is the size of 8 rows, pages are always stored one after another.
+     */
+    SSD1306_PixelFormat PixelFormat;
+    const struct SSD1306_PixelOps* PixelOps;
+    int BytesPerPage;
+
+    /* Drawing outside of Clip is ignored, the whole surface unless narrowed by SSD1306_SetClip */
+    struct SSD1306_Rect Clip;
+
+    /*
+     * Canvas the surface fields above currently describe, NULL when drawing to the display.
+     * Meanwhile the display's surface and recorder are kept in Screen and ScreenRecorder.
+     *
+     * The size and layout in Screen always describe the display and only change with the controller.
+     * Transfers and background tasks go by them, never by the surface fields a canvas is swapped into.
+     */
+    struct SSD1306_Canvas* Target;
+    struct SSD1306_Canvas Screen;
+    struct SSD1306_DisplayList* ScreenRecorder;
+
+    /* Last presented frame, NULL unless double buffering is enabled */
+    uint8_t* FrontBuffer;
+
+    /*
+     * Range of display pages currently held in Framebuffer.
+     * This is the whole display unless strip rendering is enabled.
+     */
+    int FramebufferPage;
+    int FramebufferPages;
+
+    /* Strip rendering, see ssd1306_strip.h */
+    struct SSD1306_DisplayList* Recorder;
+    int StripPages;
+
+    /* Column ordered copy of narrow regions, allocated on first use */
+    uint8_t* StagingBuffer;
+
+    /* Pages of the current interlaced frame already sent */
+    int InterlaceStep;
+
+    /*
+     * Hash of each page as sent by the last full frame, see SSD1306_SetPageHashing.
+     * A page's hash is only known to match display RAM while its bit in PageHashValid is set.
+     */
+    uint32_t PageHashes[ SSD1306_MAX_PAGES ];
+    uint32_t PageHashValid;
+    bool PageHashing;
+
+    struct SSD1306_ControllerState State;
+
     WriteCommandProc WriteCommand;
     WriteDataProc WriteData;
     ResetProc Reset;
+    WriteCommandsProc WriteCommands;
+
+    const struct SSD1306_Controller* Controller;
 
     const struct SSD1306_FontDef* Font;
     bool FontForceProportional;
     bool FontForceMonospace;
 };
 
+bool SSD1306_WriteCommand( struct SSD1306_Device* DeviceHandle, SSDCmd SSDCommand );
+bool SSD1306_WriteData( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength );
+
 void SSD1306_SetMuxRatio( struct SSD1306_Device* DeviceHandle, uint8_t Ratio );
 void SSD1306_SetDisplayOffset( struct SSD1306_Device* DeviceHandle, uint8_t Offset );
-void SSD1306_SetDisplayStartLines( struct SSD1306_Device* DeviceHandle );
+void SSD1306_SetDisplayStartLine( struct SSD1306_Device* DeviceHandle, int Line );
 void SSD1306_SetSegmentRemap( struct SSD1306_Device* DeviceHandle, bool Remap );
 void SSD1306_SetContrast( struct SSD1306_Device* DeviceHandle, uint8_t Contrast );
 void SSD1306_EnableDisplayRAM( struct SSD1306_Device* DeviceHandle );
 void SSD1306_DisableDisplayRAM( struct SSD1306_Device* DeviceHandle );
 void SSD1306_SetInverted( struct SSD1306_Device* DeviceHandle, bool Inverted );
+
+/*
+ * Mirrors the panel, 1bpp controllers only. On grayscale controllers the call is logged and ignored.
+ */
 void SSD1306_SetHFlip( struct SSD1306_Device* DeviceHandle, bool On );
 void SSD1306_SetVFlip( struct SSD1306_Device* DeviceHandle, bool On );
+
 void SSD1306_DisplayOn( struct SSD1306_Device* DeviceHandle );
 void SSD1306_DisplayOff( struct SSD1306_Device* DeviceHandle );
 void SSD1306_SetDisplayAddressMode( struct SSD1306_Device* DeviceHandle, SSD1306_AddressMode AddressMode );
 void SSD1306_Update( struct SSD1306_Device* DeviceHandle );
+void SSD1306_UpdateRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region );
+void SSD1306_UpdateRegionFrom( struct SSD1306_Device* DeviceHandle, const uint8_t* Framebuffer, const struct SSD1306_Rect* Region );
+
+/*
+ * The display's own framebuffer, even while drawing goes into a canvas.
+ * This is what updates send, call it from the task that draws.
+ */
+uint8_t* SSD1306_GetScreenFramebuffer( struct SSD1306_Device* DeviceHandle );
 void SSD1306_SetDisplayClocks( struct SSD1306_Device* DeviceHandle, uint32_t DisplayClockDivider, uint32_t OSCFrequency );
 void SSD1306_WriteRawData( struct SSD1306_Device* DeviceHandle, uint8_t* Data, size_t DataLength );
 
+/*
+ * Sends PagesPerCall pages of the framebuffer per call so the bus is
+ * only held for a bounded time, a frame takes several calls to complete.
+ * SSD1306_IsFrameComplete returns true once the last page of a frame was sent.
+ */
+void SSD1306_UpdateInterlaced( struct SSD1306_Device* DeviceHandle, SSD1306_InterlaceMode Mode, int PagesPerCall );
+bool SSD1306_IsFrameComplete( struct SSD1306_Device* DeviceHandle );
+
+/*
+ * With page hashing on, full frame updates hash every page and only send the pages
+ * whose hash differs from what was last sent, so redrawing the same frame sends nothing.
+ * Display RAM must only be written through this library while it is on.
+ */
+void SSD1306_SetPageHashing( struct SSD1306_Device* DeviceHandle, bool On );
+
+/*
+ * Allocates a zeroed buffer from DMA capable memory, as used for framebuffers.
+ */
+uint8_t* SSD1306_AllocFramebuffer( int Size );
+void SSD1306_FreeFramebuffer( uint8_t* Framebuffer );
+
+/*
+ * Adds a second framebuffer so drawing can continue into the back buffer
+ * while the front buffer is being sent.
+ */
+bool SSD1306_EnableDoubleBuffering( struct SSD1306_Device* DeviceHandle );
+void SSD1306_DisableDoubleBuffering( struct SSD1306_Device* DeviceHandle );
+
+/*
+ * Swaps the back and front buffers and sends the new front buffer.
+ */
+void SSD1306_Present( struct SSD1306_Device* DeviceHandle, SSD1306_PresentMode Mode );
+void SSD1306_PresentRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region, SSD1306_PresentMode Mode );
+
+/*
+ * Carries the last presented frame forward into the back buffer.
+ * The region version only copies the pages and columns it covers.
+ */
+void SSD1306_CopyFrontToBack( struct SSD1306_Device* DeviceHandle );
+void SSD1306_CopyFrontToBackRegion( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region );
+
 void SSD1306_SetColumnAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End );
 void SSD1306_SetPageAddress( struct SSD1306_Device* DeviceHandle, uint8_t Start, uint8_t End );
 
+/*
+ * Sends data from a buffer laid out like the framebuffer into the given
+ * display columns and pages, Data points at the first byte of StartPage.
+ * This picks whatever the controller supports, a single transfer for full
+ * width windows where possible and one transfer per page otherwise.
+ */
+void SSD1306_WriteWindow( struct SSD1306_Device* DeviceHandle, const uint8_t* Data, int Left, int Right, int StartPage, int EndPage );
+
 bool SSD1306_HWReset( struct SSD1306_Device* DeviceHandle );
 
+/*
+ * Returns the descriptor for a controller, or NULL if it is not supported.
+ */
+const struct SSD1306_Controller* SSD1306_GetController( SSD1306_ControllerType Type );
+
+/*
+ * Returns the init sequence of Controller that best fits a panel Height rows tall.
+ */
+const struct SSD1306_InitSequence* SSD1306_GetInitSequence( const struct SSD1306_Controller* Controller, int Height );
+
+/*
+ * Displays are initialized for CONFIG_SSD1306_DEFAULT_CONTROLLER, this
+ * switches an initialized display over to another controller and initializes it again.
+ */
+bool SSD1306_SetController( struct SSD1306_Device* DeviceHandle, SSD1306_ControllerType Type );
+
+/*
+ * Forgets what the controller was last sent so every setter goes out again.
+ * Call this after the display was reset or powered off behind the driver's back.
+ */
+void SSD1306_InvalidateState( struct SSD1306_Device* DeviceHandle );
+
 bool SSD1306_Init_I2C( struct SSD1306_Device* DeviceHandle, int Width, int Height, int I2CAddress, int ResetPin, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset );
 bool SSD1306_Init_SPI( struct SSD1306_Device* DeviceHandle, int Width, int Height, int ResetPin, int CSPin, spi_device_handle_t SPIHandle, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset );
 
+/*
+ * Same as above, but also take WriteCommands which sends a whole command sequence
+ * in one bus transaction. It may be NULL, without it command sequences
+ * are sent one byte at a time through WriteCommand.
+ */
+bool SSD1306_Init_I2C_Ex( struct SSD1306_Device* DeviceHandle, int Width, int Height, int I2CAddress, int ResetPin, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset, WriteCommandsProc WriteCommands );
+bool SSD1306_Init_SPI_Ex( struct SSD1306_Device* DeviceHandle, int Width, int Height, int ResetPin, int CSPin, spi_device_handle_t SPIHandle, WriteCommandProc WriteCommand, WriteDataProc WriteData, ResetProc Reset, WriteCommandsProc WriteCommands );
+
+/*
+ * Brings an already initialized display back after it lost its configuration,
+ * for example after a brownout. The init sequence is sent again and contrast,
+ * inversion and flips are restored, but display RAM is neither cleared nor resent.
+ */
+bool SSD1306_WarmInit( struct SSD1306_Device* DeviceHandle );
+
 #ifdef __cplusplus
 }
 #endif
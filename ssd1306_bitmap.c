@@ -0,0 +1,401 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_displaylist.h"
+
+static int GetStride( const struct SSD1306_Bitmap* Bitmap ) {
+    if ( Bitmap->Stride > 0 ) {
+        return Bitmap->Stride;
+    }
+
+    return ( Bitmap->Format == BitmapFormat_Page ) ? Bitmap->Width : ( Bitmap->Width + 7 ) / 8;
+}
+
+/*
+ * The strip functions fill Strip with one byte per column holding source rows Y to Y + 7, row Y in bit 0.
+ * Rows past the bottom of the bitmap are left clear.
+ */
+static void GetPageStrip( const struct SSD1306_Bitmap* Bitmap, int Stride, int X, int Y, int Count, uint8_t* Strip ) {
+    const uint8_t* Upper = &Bitmap->Data[ ( ( Y >> 3 ) * Stride ) + X ];
+    const uint8_t* Lower = Upper + Stride;
+    int Shift = Y & 0x07;
+    int i = 0;
+
+    if ( Shift == 0 ) {
+        memcpy( Strip, Upper, Count );
+    } else if ( ( ( Y >> 3 ) + 1 ) * 8 < Bitmap->Height ) {
+        for ( i = 0; i < Count; i++ ) {
+            Strip[ i ] = ( Upper[ i ] >> Shift ) | ( Lower[ i ] << ( 8 - Shift ) );
+        }
+    } else {
+        for ( i = 0; i < Count; i++ ) {
+            Strip[ i ] = Upper[ i ] >> Shift;
+        }
+    }
+}
+
+static inline uint8_t GetRowBits( const uint8_t* Row, int RowBytes, int X ) {
+    int Byte = X >> 3;
+    int Shift = X & 0x07;
+
+    if ( Shift != 0 && Byte + 1 < RowBytes ) {
+        return ( Row[ Byte ] >> Shift ) | ( Row[ Byte + 1 ] << ( 8 - Shift ) );
+    }
+
+    return Row[ Byte ] >> Shift;
+}
+
+/*
+ * Row format sources are gathered 8 columns by 8 rows at a time and transposed into page bytes.
+ */
+static void GetRowStrip( const struct SSD1306_Bitmap* Bitmap, int Stride, int X, int Y, int Count, uint8_t* Strip ) {
+    const uint8_t* Rows[ 8 ];
+    int RowBytes = ( Bitmap->Width + 7 ) / 8;
+    uint64_t Block = 0;
+    int Row = 0;
+    int i = 0;
+    int j = 0;
+
+    for ( Row = 0; Row < 8; Row++ ) {
+        Rows[ Row ] = ( Y + Row < Bitmap->Height ) ? &Bitmap->Data[ ( Y + Row ) * Stride ] : NULL;
+    }
+
+    for ( i = 0; i < Count; i+= 8 ) {
+        for ( Block = 0, Row = 0; Row < 8 && Rows[ Row ] != NULL; Row++ ) {
+            Block|= ( uint64_t ) GetRowBits( Rows[ Row ], RowBytes, X + i ) << ( Row * 8 );
+        }
+
+        Block = SSD1306_Transpose8x8( Block );
+
+        for ( j = 0; j < 8 && i + j < Count; j++, Block>>= 8 ) {
+            Strip[ i + j ] = Block & 0xFF;
+        }
+    }
+}
+
+/*
+ * Combines Count source bytes into the destination, only bits set in Mask are touched.
+ */
+static void ApplySpan( uint8_t* Dest, const uint8_t* Source, int Count, uint8_t Mask, SSD1306_RasterOp Op ) {
+    int i = 0;
+
+    switch ( Op ) {
+        case RasterOp_Copy: {
+            if ( Mask == 0xFF ) {
+                memcpy( Dest, Source, Count );
+            } else {
+                for ( i = 0; i < Count; i++ ) {
+                    Dest[ i ] = ( Dest[ i ] & ~Mask ) | ( Source[ i ] & Mask );
+                }
+            }
+
+            break;
+        }
+        case RasterOp_Or: {
+            for ( i = 0; i < Count; i++ ) {
+                Dest[ i ]|= Source[ i ] & Mask;
+            }
+
+            break;
+        }
+        case RasterOp_And: {
+            for ( i = 0; i < Count; i++ ) {
+                Dest[ i ]&= Source[ i ] | ~Mask;
+            }
+
+            break;
+        }
+        case RasterOp_Xor: {
+            for ( i = 0; i < Count; i++ ) {
+                Dest[ i ]^= Source[ i ] & Mask;
+            }
+
+            break;
+        }
+        case RasterOp_AndNot: {
+            for ( i = 0; i < Count; i++ ) {
+                Dest[ i ]&= ~( Source[ i ] & Mask );
+            }
+
+            break;
+        }
+        default: break;
+    }
+}
+
+/*
+ * Source pixels under set mask bits replace the destination, the rest is left alone.
+ */
+static void ApplyMaskedSpan( uint8_t* Dest, const uint8_t* Source, const uint8_t* SourceMask, int Count, uint8_t Mask ) {
+    uint8_t Keep = 0;
+    int i = 0;
+
+    for ( i = 0; i < Count; i++ ) {
+        Keep = SourceMask[ i ] & Mask;
+        Dest[ i ] = ( Dest[ i ] & ~Keep ) | ( Source[ i ] & Keep );
+    }
+}
+
+static bool GetBitmapPixel( const struct SSD1306_Bitmap* Bitmap, int Stride, int X, int Y ) {
+    if ( Bitmap->Format == BitmapFormat_Page ) {
+        return ( Bitmap->Data[ ( ( Y >> 3 ) * Stride ) + X ] & BIT( Y & 0x07 ) ) ? true : false;
+    }
+
+    return ( Bitmap->Data[ ( Y * Stride ) + ( X >> 3 ) ] & BIT( X & 0x07 ) ) ? true : false;
+}
+
+/*
+ * Part of a bitmap that survives clipping and where it goes on screen.
+ */
+struct BlitArea {
+    int SourceX;
+    int SourceY;
+    int X;
+    int Y;
+    int Columns;
+    int Rows;
+};
+
+/*
+ * Clips the Source part of a Width x Height bitmap placed at x, y against the clip rectangle and framebuffer band.
+ * Returns false if nothing is left.
+ */
+static bool ClipBlit( struct SSD1306_Device* DeviceHandle, int Width, int Height, const struct SSD1306_Rect* Source, int x, int y, struct BlitArea* Area ) {
+    struct SSD1306_Rect Clip;
+    int BandTop = 0;
+    int BandBottom = 0;
+
+    Clip.Left = 0;
+    Clip.Top = 0;
+    Clip.Right = Width - 1;
+    Clip.Bottom = Height - 1;
+
+    if ( Source != NULL ) {
+        x+= ( Source->Left < 0 ) ? -Source->Left : 0;
+        y+= ( Source->Top < 0 ) ? -Source->Top : 0;
+
+        SSD1306_RectIntersect( &Clip, Source );
+    }
+
+    /* Move whatever falls outside the clip rectangle or framebuffer band out of the source rectangle */
+    BandTop = DeviceHandle->FramebufferPage * 8;
+    BandBottom = ( DeviceHandle->FramebufferPage + DeviceHandle->FramebufferPages ) * 8;
+
+    BandTop = ( BandTop < DeviceHandle->Clip.Top ) ? DeviceHandle->Clip.Top : BandTop;
+    BandBottom = ( BandBottom > DeviceHandle->Clip.Bottom + 1 ) ? DeviceHandle->Clip.Bottom + 1 : BandBottom;
+
+    if ( x < DeviceHandle->Clip.Left ) {
+        Clip.Left+= DeviceHandle->Clip.Left - x;
+        x = DeviceHandle->Clip.Left;
+    }
+
+    if ( y < BandTop ) {
+        Clip.Top+= BandTop - y;
+        y = BandTop;
+    }
+
+    Area->SourceX = Clip.Left;
+    Area->SourceY = Clip.Top;
+    Area->X = x;
+    Area->Y = y;
+    Area->Columns = ( Clip.Right - Clip.Left ) + 1;
+    Area->Rows = ( Clip.Bottom - Clip.Top ) + 1;
+
+    Area->Columns = ( x + Area->Columns > DeviceHandle->Clip.Right + 1 ) ? ( DeviceHandle->Clip.Right + 1 ) - x : Area->Columns;
+    Area->Rows = ( y + Area->Rows > BandBottom ) ? BandBottom - y : Area->Rows;
+
+    return ( Area->Columns > 0 && Area->Rows > 0 ) ? true : false;
+}
+
+/*
+ * Page bytes of source rows Y to Y + 7, either straight from the bitmap or gathered into Strip.
+ */
+static const uint8_t* GetStrip( const struct SSD1306_Bitmap* Bitmap, int Stride, int X, int Y, int Count, uint8_t* Strip ) {
+    if ( Bitmap->Format == BitmapFormat_Page ) {
+        /* Source pages line up, no need to gather them */
+        if ( ( Y & 0x07 ) == 0 ) {
+            return &Bitmap->Data[ ( ( Y >> 3 ) * Stride ) + X ];
+        }
+
+        GetPageStrip( Bitmap, Stride, X, Y, Count, Strip );
+    } else {
+        GetRowStrip( Bitmap, Stride, X, Y, Count, Strip );
+    }
+
+    return Strip;
+}
+
+/*
+ * Splits page bytes that straddle two destination pages, the bottom part goes into Spill.
+ */
+static void ShiftStrip( const uint8_t* Bytes, uint8_t* Strip, uint8_t* Spill, int Count, int Shift ) {
+    int i = 0;
+
+    for ( i = 0; i < Count; i++ ) {
+        Spill[ i ] = Bytes[ i ] >> ( 8 - Shift );
+        Strip[ i ] = Bytes[ i ] << Shift;
+    }
+}
+
+/*
+ * Formats other than 1bpp go through the pixel kernels.
+ */
+static void BlitSlow( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct BlitArea* Area, SSD1306_RasterOp Op ) {
+    int Stride = GetStride( Bitmap );
+    int MaskStride = ( Mask != NULL ) ? GetStride( Mask ) : 0;
+    bool Set = false;
+    int X = 0;
+    int Y = 0;
+
+    for ( Y = 0; Y < Area->Rows; Y++ ) {
+        for ( X = 0; X < Area->Columns; X++ ) {
+            if ( Mask != NULL && GetBitmapPixel( Mask, MaskStride, Area->SourceX + X, Area->SourceY + Y ) == false ) {
+                continue;
+            }
+
+            Set = GetBitmapPixel( Bitmap, Stride, Area->SourceX + X, Area->SourceY + Y );
+
+            if ( Op == RasterOp_Copy || ( Set == true && Op != RasterOp_And ) || ( Set == false && Op == RasterOp_And ) ) {
+                switch ( Op ) {
+                    case RasterOp_Xor: {
+                        DeviceHandle->PixelOps->Plot( DeviceHandle, Area->X + X, Area->Y + Y, SSD_COLOR_XOR );
+                        break;
+                    }
+                    case RasterOp_Copy:
+                    case RasterOp_Or: {
+                        DeviceHandle->PixelOps->Plot( DeviceHandle, Area->X + X, Area->Y + Y, ( Set == true ) ? SSD_COLOR_WHITE : SSD_COLOR_BLACK );
+                        break;
+                    }
+                    default: {
+                        DeviceHandle->PixelOps->Plot( DeviceHandle, Area->X + X, Area->Y + Y, SSD_COLOR_BLACK );
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Walks the area 8 source rows at a time, with a Mask only the pixels it covers are copied and Op is ignored.
+ */
+static void Blit( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct BlitArea* Area, SSD1306_RasterOp Op ) {
+    uint8_t Strip[ SSD1306_MAX_COLUMNS ];
+    uint8_t Spill[ SSD1306_MAX_COLUMNS ];
+    uint8_t MaskStrip[ SSD1306_MAX_COLUMNS ];
+    uint8_t MaskSpill[ SSD1306_MAX_COLUMNS ];
+    const uint8_t* MaskBytes = NULL;
+    const uint8_t* Bytes = NULL;
+    uint8_t* Dest = NULL;
+    uint8_t RowMask = 0;
+    int Stride = 0;
+    int MaskStride = 0;
+    int Shift = 0;
+    int Row = 0;
+
+    if ( DeviceHandle->PixelFormat != PixelFormat_Mono ) {
+        BlitSlow( DeviceHandle, Bitmap, Mask, Area, Op );
+        return;
+    }
+
+    Stride = GetStride( Bitmap );
+    MaskStride = ( Mask != NULL ) ? GetStride( Mask ) : 0;
+    Shift = Area->Y & 0x07;
+
+    for ( Row = 0; Row < Area->Rows; Row+= 8 ) {
+        RowMask = ( Area->Rows - Row >= 8 ) ? 0xFF : 0xFF >> ( 8 - ( Area->Rows - Row ) );
+        Dest = &DeviceHandle->Framebuffer[ ( ( ( ( Area->Y + Row ) >> 3 ) - DeviceHandle->FramebufferPage ) * DeviceHandle->BytesPerPage ) + Area->X ];
+
+        Bytes = GetStrip( Bitmap, Stride, Area->SourceX, Area->SourceY + Row, Area->Columns, Strip );
+        MaskBytes = ( Mask != NULL ) ? GetStrip( Mask, MaskStride, Area->SourceX, Area->SourceY + Row, Area->Columns, MaskStrip ) : NULL;
+
+        if ( Shift != 0 ) {
+            ShiftStrip( Bytes, Strip, Spill, Area->Columns, Shift );
+            Bytes = Strip;
+
+            if ( MaskBytes != NULL ) {
+                ShiftStrip( MaskBytes, MaskStrip, MaskSpill, Area->Columns, Shift );
+                MaskBytes = MaskStrip;
+            }
+
+            /* Rows that spill into the next page */
+            if ( ( RowMask >> ( 8 - Shift ) ) != 0 ) {
+                if ( Mask != NULL ) {
+                    ApplyMaskedSpan( Dest + DeviceHandle->BytesPerPage, Spill, MaskSpill, Area->Columns, RowMask >> ( 8 - Shift ) );
+                } else {
+                    ApplySpan( Dest + DeviceHandle->BytesPerPage, Spill, Area->Columns, RowMask >> ( 8 - Shift ), Op );
+                }
+            }
+
+            RowMask = ( RowMask << Shift ) & 0xFF;
+        }
+
+        if ( Mask != NULL ) {
+            ApplyMaskedSpan( Dest, Bytes, MaskBytes, Area->Columns, RowMask );
+        } else {
+            ApplySpan( Dest, Bytes, Area->Columns, RowMask, Op );
+        }
+    }
+}
+
+void SSD1306_DrawBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Rect* Source, int x, int y, SSD1306_RasterOp Op ) {
+    struct BlitArea Area;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( Bitmap, return );
+    NullCheck( Bitmap->Data, return );
+
+    CheckBounds( Op < RasterOp_Copy || Op > RasterOp_AndNot, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecordBitmap( DeviceHandle, Bitmap, NULL, Source, x, y, Op );
+        return;
+    }
+
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    if ( ClipBlit( DeviceHandle, Bitmap->Width, Bitmap->Height, Source, x, y, &Area ) == false ) {
+        ClipDebug( x, y );
+        return;
+    }
+
+    Blit( DeviceHandle, Bitmap, NULL, &Area, Op );
+}
+
+void SSD1306_DrawMaskedBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct SSD1306_Rect* Source, int x, int y ) {
+    struct BlitArea Area;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( Bitmap, return );
+    NullCheck( Bitmap->Data, return );
+    NullCheck( Mask, return );
+    NullCheck( Mask->Data, return );
+
+    CheckBounds( Mask->Width < Bitmap->Width || Mask->Height < Bitmap->Height, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecordBitmap( DeviceHandle, Bitmap, Mask, Source, x, y, RasterOp_Copy );
+        return;
+    }
+
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    if ( ClipBlit( DeviceHandle, Bitmap->Width, Bitmap->Height, Source, x, y, &Area ) == false ) {
+        ClipDebug( x, y );
+        return;
+    }
+
+    Blit( DeviceHandle, Bitmap, Mask, &Area, RasterOp_Copy );
+}
@@ -0,0 +1,88 @@
+#ifndef _SSD1306_BITMAP_H_
+#define _SSD1306_BITMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    /* Pages of 8 rows, each byte a column with the top row in bit 0, same as the framebuffer */
+    BitmapFormat_Page = 0,
+    /* Rows of bytes with the leftmost pixel in bit 0, as in XBM files */
+    BitmapFormat_Row
+} SSD1306_BitmapFormat;
+
+typedef enum {
+    /* Destination = Source */
+    RasterOp_Copy = 0,
+    /* Set pixels of the source are lit */
+    RasterOp_Or,
+    /* Pixels clear in the source are cleared */
+    RasterOp_And,
+    /* Set pixels of the source are inverted */
+    RasterOp_Xor,
+    /* Set pixels of the source are cleared */
+    RasterOp_AndNot
+} SSD1306_RasterOp;
+
+struct SSD1306_Bitmap {
+    const uint8_t* Data;
+
+    int Width;
+    int Height;
+
+    SSD1306_BitmapFormat Format;
+
+    /* Bytes from one page or row to the next, 0 if they are packed */
+    int Stride;
+};
+
+/*
+ * Transposes an 8x8 bit matrix held one row per byte, bit c of byte r ends up as bit r of byte c.
+ * Turns 8 rows of pixels into 8 page format columns and back.
+ */
+static inline uint64_t SSD1306_Transpose8x8( uint64_t Bits ) {
+    uint64_t Swap = 0;
+
+    Swap = ( Bits ^ ( Bits >> 7 ) ) & 0x00AA00AA00AA00AAULL;
+    Bits^= Swap ^ ( Swap << 7 );
+
+    Swap = ( Bits ^ ( Bits >> 14 ) ) & 0x0000CCCC0000CCCCULL;
+    Bits^= Swap ^ ( Swap << 14 );
+
+    Swap = ( Bits ^ ( Bits >> 28 ) ) & 0x00000000F0F0F0F0ULL;
+    Bits^= Swap ^ ( Swap << 28 );
+
+    return Bits;
+}
+
+/*
+ * Draws the Source part of Bitmap with its top left corner at x, y.
+ *
+ * Params:
+ * Bitmap: 1bpp source image
+ * Source: Part of the bitmap to draw in bitmap coordinates, NULL draws all of it
+ * x, y: Where the top left pixel of Source goes, the bitmap is clipped to the screen
+ * Op: How the source is combined with what is already there
+ *
+ * On grayscale panels lit pixels are drawn white.
+ * While strip rendering or recording a display list the bitmap is recorded by reference,
+ * its data has to stay valid until the list is drawn.
+ */
+void SSD1306_DrawBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Rect* Source, int x, int y, SSD1306_RasterOp Op );
+
+/*
+ * As above but only pixels set in Mask are drawn, lit or not, the rest stay as they were.
+ * Mask may be in either format and must be at least as large as Bitmap.
+ */
+void SSD1306_DrawMaskedBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct SSD1306_Rect* Source, int x, int y );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,491 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#if ! defined ESP_PLATFORM && defined __linux__
+/* For pthread_setaffinity_np */
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bus.h"
+
+#if defined ESP_PLATFORM
+static const int BusStackSize = CONFIG_SSD1306_BUS_STACK_SIZE;
+static const int BusPriority = CONFIG_SSD1306_BUS_PRIORITY;
+#endif
+
+static bool HasWork( const struct SSD1306_BusClient* Client ) {
+    return ( SSD1306_RectIsEmpty( &Client->Sending ) == false || SSD1306_RectIsEmpty( &Client->Queued ) == false ) ? true : false;
+}
+
+static bool IsIdle( const struct SSD1306_BusClient* Client ) {
+    return ( HasWork( Client ) == false && Client->InFlight == false ) ? true : false;
+}
+
+static int FindClient( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle ) {
+    int i = 0;
+
+    for ( i = 0; i < Bus->ClientCount; i++ ) {
+        if ( Bus->Clients[ i ].Device == DeviceHandle ) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+#if defined ESP_PLATFORM
+
+static void LockClients( struct SSD1306_Bus* Bus ) {
+    xSemaphoreTake( Bus->Lock, portMAX_DELAY );
+}
+
+static void UnlockClients( struct SSD1306_Bus* Bus ) {
+    xSemaphoreGive( Bus->Lock );
+}
+
+/*
+ * Called with the clients locked.
+ */
+static void SetIdle( struct SSD1306_Bus* Bus, int Index, bool Idle ) {
+    if ( Idle == true ) {
+        xEventGroupSetBits( Bus->Idle, BIT( Index ) );
+    } else {
+        xEventGroupClearBits( Bus->Idle, BIT( Index ) );
+    }
+}
+
+static void WaitIdle( struct SSD1306_Bus* Bus, int Index ) {
+    xEventGroupWaitBits( Bus->Idle, BIT( Index ), pdFALSE, pdTRUE, portMAX_DELAY );
+}
+
+#else
+
+static void LockClients( struct SSD1306_Bus* Bus ) {
+    pthread_mutex_lock( &Bus->Lock );
+}
+
+static void UnlockClients( struct SSD1306_Bus* Bus ) {
+    pthread_mutex_unlock( &Bus->Lock );
+}
+
+static void SetIdle( struct SSD1306_Bus* Bus, int Index, bool Idle ) {
+    /* Waiters check their own client once woken, so which one went idle does not matter */
+    ( void ) Index;
+
+    if ( Idle == true ) {
+        pthread_cond_broadcast( &Bus->Idle );
+    }
+}
+
+static void WaitIdle( struct SSD1306_Bus* Bus, int Index ) {
+    pthread_mutex_lock( &Bus->Lock );
+        while ( IsIdle( &Bus->Clients[ Index ] ) == false ) {
+            pthread_cond_wait( &Bus->Idle, &Bus->Lock );
+        }
+    pthread_mutex_unlock( &Bus->Lock );
+}
+
+#endif
+
+/*
+ * Gives the next device with work its turn, returns false once no device has any.
+ */
+static bool SendTurn( struct SSD1306_Bus* Bus ) {
+    struct SSD1306_BusClient* Client = NULL;
+    const uint8_t* Framebuffer = NULL;
+    struct SSD1306_Rect Batch;
+    int PageBytes = 0;
+    int Pages = 0;
+    int Index = 0;
+    int i = 0;
+
+    LockClients( Bus );
+
+    for ( i = 0; i < Bus->ClientCount && Client == NULL; i++ ) {
+        Index = ( Bus->Next + i ) % Bus->ClientCount;
+        Client = ( HasWork( &Bus->Clients[ Index ] ) == true ) ? &Bus->Clients[ Index ] : NULL;
+    }
+
+    if ( Client == NULL ) {
+        UnlockClients( Bus );
+        return false;
+    }
+
+    Bus->Next = ( Index + 1 ) % Bus->ClientCount;
+
+    /* Damage queued while the previous region was being sent is picked up as a whole */
+    if ( SSD1306_RectIsEmpty( &Client->Sending ) == true ) {
+        Client->Sending = Client->Queued;
+        Client->Page = Client->Sending.Top / 8;
+
+        SSD1306_RectSetEmpty( &Client->Queued );
+    }
+
+    Client->Deficit+= Bus->Quantum * Client->Priority;
+
+    PageBytes = ( ( Client->Sending.Right - Client->Sending.Left ) + 1 ) * SSD1306_GetPixelOps( Client->Device->Screen.PixelFormat )->Depth;
+    Pages = ( Client->Deficit - SSD1306_BUS_WINDOW_COST ) / PageBytes;
+
+    /* Not enough for a page yet, what was given is kept for the next turn */
+    if ( Pages < 1 ) {
+        UnlockClients( Bus );
+        return true;
+    }
+
+    Pages = ( Pages > ( ( Client->Sending.Bottom / 8 ) - Client->Page ) + 1 ) ? ( ( Client->Sending.Bottom / 8 ) - Client->Page ) + 1 : Pages;
+
+    Batch.Left = Client->Sending.Left;
+    Batch.Right = Client->Sending.Right;
+    Batch.Top = Client->Page * 8;
+    Batch.Bottom = ( ( Client->Page + Pages ) * 8 ) - 1;
+
+    Client->Page+= Pages;
+    Client->Deficit-= ( Pages * PageBytes ) + SSD1306_BUS_WINDOW_COST;
+
+    if ( Client->Page > Client->Sending.Bottom / 8 ) {
+        SSD1306_RectSetEmpty( &Client->Sending );
+    }
+
+    Client->InFlight = true;
+    Framebuffer = Client->Framebuffer;
+
+    UnlockClients( Bus );
+
+    SSD1306_BusLock( Bus );
+        SSD1306_UpdateRegionFrom( Client->Device, Framebuffer, &Batch );
+    SSD1306_BusUnlock( Bus );
+
+    LockClients( Bus );
+        Client->BytesSent+= Pages * PageBytes;
+        Client->Batches++;
+        Client->InFlight = false;
+
+        /* An idle device starts its next round from nothing */
+        if ( HasWork( Client ) == false ) {
+            Client->Deficit = 0;
+            SetIdle( Bus, Index, true );
+        }
+    UnlockClients( Bus );
+
+    return true;
+}
+
+static void SendAll( struct SSD1306_Bus* Bus ) {
+    bool Busy = true;
+
+    while ( Busy == true ) {
+        Busy = SendTurn( Bus );
+    }
+}
+
+#if defined ESP_PLATFORM
+
+static void BusTask( void* Param ) {
+    struct SSD1306_Bus* Bus = ( struct SSD1306_Bus* ) Param;
+
+    while ( atomic_load( &Bus->Running ) == true ) {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        SendAll( Bus );
+    }
+
+    /* Everything submitted before stopping still goes out */
+    SendAll( Bus );
+
+    xSemaphoreGive( Bus->Stopped );
+    vTaskDelete( NULL );
+}
+
+static void DeleteSync( struct SSD1306_Bus* Bus ) {
+    if ( Bus->Idle != NULL ) {
+        vEventGroupDelete( Bus->Idle );
+    }
+
+    if ( Bus->Transfer != NULL ) {
+        vSemaphoreDelete( Bus->Transfer );
+    }
+
+    if ( Bus->Lock != NULL ) {
+        vSemaphoreDelete( Bus->Lock );
+    }
+
+    if ( Bus->Stopped != NULL ) {
+        vSemaphoreDelete( Bus->Stopped );
+    }
+
+    Bus->Idle = NULL;
+    Bus->Transfer = NULL;
+    Bus->Lock = NULL;
+    Bus->Stopped = NULL;
+}
+
+static bool StartTask( struct SSD1306_Bus* Bus, int Core ) {
+    Bus->Stopped = xSemaphoreCreateBinary( );
+    Bus->Lock = xSemaphoreCreateMutex( );
+    Bus->Transfer = xSemaphoreCreateMutex( );
+    Bus->Idle = xEventGroupCreate( );
+
+    if ( Bus->Stopped == NULL || Bus->Lock == NULL || Bus->Transfer == NULL || Bus->Idle == NULL ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create bus locks" );
+
+        DeleteSync( Bus );
+        return false;
+    }
+
+    if ( xTaskCreatePinnedToCore( BusTask, "ssd1306_bus", BusStackSize, Bus, BusPriority, &Bus->Task, ( Core < 0 ) ? tskNO_AFFINITY : Core ) != pdPASS ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create bus task" );
+
+        DeleteSync( Bus );
+        return false;
+    }
+
+    return true;
+}
+
+static void WakeTask( struct SSD1306_Bus* Bus ) {
+    xTaskNotifyGive( Bus->Task );
+}
+
+static void JoinTask( struct SSD1306_Bus* Bus ) {
+    xSemaphoreTake( Bus->Stopped, portMAX_DELAY );
+    DeleteSync( Bus );
+}
+
+void SSD1306_BusLock( struct SSD1306_Bus* Bus ) {
+    NullCheck( Bus, return );
+    NullCheck( Bus->Transfer, return );
+
+    xSemaphoreTake( Bus->Transfer, portMAX_DELAY );
+}
+
+void SSD1306_BusUnlock( struct SSD1306_Bus* Bus ) {
+    NullCheck( Bus, return );
+    NullCheck( Bus->Transfer, return );
+
+    xSemaphoreGive( Bus->Transfer );
+}
+
+#else
+
+/*
+ * POSIX backend so the arbiter can be exercised on a host build.
+ */
+static void* BusThread( void* Param ) {
+    struct SSD1306_Bus* Bus = ( struct SSD1306_Bus* ) Param;
+
+    while ( atomic_load( &Bus->Running ) == true ) {
+        pthread_mutex_lock( &Bus->Lock );
+
+        while ( Bus->WakePending == false ) {
+            pthread_cond_wait( &Bus->Wake, &Bus->Lock );
+        }
+
+        Bus->WakePending = false;
+        pthread_mutex_unlock( &Bus->Lock );
+
+        SendAll( Bus );
+    }
+
+    SendAll( Bus );
+    return NULL;
+}
+
+static bool StartTask( struct SSD1306_Bus* Bus, int Core ) {
+#if defined __linux__
+    cpu_set_t CPUSet;
+#endif
+
+    pthread_mutex_init( &Bus->Lock, NULL );
+    pthread_mutex_init( &Bus->Transfer, NULL );
+    pthread_cond_init( &Bus->Wake, NULL );
+    pthread_cond_init( &Bus->Idle, NULL );
+    Bus->WakePending = false;
+
+    if ( pthread_create( &Bus->Thread, NULL, BusThread, Bus ) != 0 ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create bus thread" );
+
+        pthread_cond_destroy( &Bus->Idle );
+        pthread_cond_destroy( &Bus->Wake );
+        pthread_mutex_destroy( &Bus->Transfer );
+        pthread_mutex_destroy( &Bus->Lock );
+        return false;
+    }
+
+#if defined __linux__
+    if ( Core >= 0 ) {
+        CPU_ZERO( &CPUSet );
+        CPU_SET( Core, &CPUSet );
+
+        pthread_setaffinity_np( Bus->Thread, sizeof( CPUSet ), &CPUSet );
+    }
+#endif
+
+    return true;
+}
+
+static void WakeTask( struct SSD1306_Bus* Bus ) {
+    pthread_mutex_lock( &Bus->Lock );
+        Bus->WakePending = true;
+        pthread_cond_signal( &Bus->Wake );
+    pthread_mutex_unlock( &Bus->Lock );
+}
+
+static void JoinTask( struct SSD1306_Bus* Bus ) {
+    pthread_join( Bus->Thread, NULL );
+
+    pthread_cond_destroy( &Bus->Idle );
+    pthread_cond_destroy( &Bus->Wake );
+    pthread_mutex_destroy( &Bus->Transfer );
+    pthread_mutex_destroy( &Bus->Lock );
+}
+
+void SSD1306_BusLock( struct SSD1306_Bus* Bus ) {
+    NullCheck( Bus, return );
+    pthread_mutex_lock( &Bus->Transfer );
+}
+
+void SSD1306_BusUnlock( struct SSD1306_Bus* Bus ) {
+    NullCheck( Bus, return );
+    pthread_mutex_unlock( &Bus->Transfer );
+}
+
+#endif
+
+bool SSD1306_BusInit( struct SSD1306_Bus* Bus, int Quantum ) {
+    NullCheck( Bus, return false );
+    CheckBounds( Quantum < 1, return false );
+
+    memset( Bus, 0, sizeof( struct SSD1306_Bus ) );
+
+    Bus->Quantum = Quantum;
+    atomic_init( &Bus->Running, false );
+
+    return true;
+}
+
+bool SSD1306_BusAttach( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle, int Priority ) {
+    struct SSD1306_BusClient* Client = NULL;
+
+    NullCheck( Bus, return false );
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckBounds( atomic_load( &Bus->Running ) == true, return false );
+    CheckBounds( Bus->ClientCount >= SSD1306_BUS_MAX_DEVICES, return false );
+    CheckBounds( FindClient( Bus, DeviceHandle ) >= 0, return false );
+    CheckBounds( DeviceHandle->StripPages > 0, return false );
+    CheckBounds( Priority < 1, return false );
+
+    Client = &Bus->Clients[ Bus->ClientCount++ ];
+
+    memset( Client, 0, sizeof( struct SSD1306_BusClient ) );
+
+    Client->Device = DeviceHandle;
+    Client->Priority = Priority;
+
+    SSD1306_RectSetEmpty( &Client->Sending );
+    SSD1306_RectSetEmpty( &Client->Queued );
+
+    return true;
+}
+
+bool SSD1306_BusStart( struct SSD1306_Bus* Bus, int Core ) {
+    int i = 0;
+
+    NullCheck( Bus, return false );
+    CheckBounds( atomic_load( &Bus->Running ) == true, return false );
+
+    for ( i = 0; i < Bus->ClientCount; i++ ) {
+        SSD1306_RectSetEmpty( &Bus->Clients[ i ].Sending );
+        SSD1306_RectSetEmpty( &Bus->Clients[ i ].Queued );
+
+        Bus->Clients[ i ].Deficit = 0;
+    }
+
+    atomic_store( &Bus->Running, true );
+
+    if ( StartTask( Bus, Core ) == false ) {
+        atomic_store( &Bus->Running, false );
+        return false;
+    }
+
+    LockClients( Bus );
+        for ( i = 0; i < Bus->ClientCount; i++ ) {
+            SetIdle( Bus, i, true );
+        }
+    UnlockClients( Bus );
+
+    return true;
+}
+
+void SSD1306_BusStop( struct SSD1306_Bus* Bus ) {
+    NullCheck( Bus, return );
+
+    if ( atomic_load( &Bus->Running ) == false ) {
+        return;
+    }
+
+    atomic_store( &Bus->Running, false );
+
+    WakeTask( Bus );
+    JoinTask( Bus );
+}
+
+void SSD1306_BusUpdateRegion( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region ) {
+    struct SSD1306_Rect Rect;
+    int Index = 0;
+
+    NullCheck( Bus, return );
+    NullCheck( DeviceHandle, return );
+
+    CheckBounds( atomic_load( &Bus->Running ) == false, return );
+    CheckBounds( ( Index = FindClient( Bus, DeviceHandle ) ) < 0, return );
+
+    Rect.Left = 0;
+    Rect.Top = 0;
+    Rect.Right = DeviceHandle->Screen.Width - 1;
+    Rect.Bottom = DeviceHandle->Screen.Height - 1;
+
+    if ( Region != NULL ) {
+        SSD1306_RectIntersect( &Rect, Region );
+    }
+
+    if ( SSD1306_RectIsEmpty( &Rect ) == true ) {
+        return;
+    }
+
+    Rect.Top&= ~0x07;
+    Rect.Bottom = ( ( Rect.Bottom | 0x07 ) >= DeviceHandle->Screen.Height ) ? DeviceHandle->Screen.Height - 1 : Rect.Bottom | 0x07;
+
+    LockClients( Bus );
+        /* Double buffering moves the framebuffer, so it is picked up again with every submission */
+        Bus->Clients[ Index ].Framebuffer = SSD1306_GetScreenFramebuffer( DeviceHandle );
+        SSD1306_RectUnion( &Bus->Clients[ Index ].Queued, &Rect );
+        SetIdle( Bus, Index, false );
+    UnlockClients( Bus );
+
+    WakeTask( Bus );
+}
+
+void SSD1306_BusWait( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle ) {
+    int Index = 0;
+
+    NullCheck( Bus, return );
+    NullCheck( DeviceHandle, return );
+
+    CheckBounds( atomic_load( &Bus->Running ) == false, return );
+    CheckBounds( ( Index = FindClient( Bus, DeviceHandle ) ) < 0, return );
+
+    WaitIdle( Bus, Index );
+}
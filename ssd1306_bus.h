@@ -0,0 +1,149 @@
+#ifndef _SSD1306_BUS_H_
+#define _SSD1306_BUS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ssd1306.h"
+
+#if defined ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSD1306_BUS_MAX_DEVICES 8
+
+/*
+ * Number of bytes a window is charged on top of its data,
+ * the column and page address commands are 3 bytes each.
+ */
+#define SSD1306_BUS_WINDOW_COST 6
+
+struct SSD1306_BusClient {
+    struct SSD1306_Device* Device;
+
+    /* Share of the bus relative to the other devices, at least 1 */
+    int Priority;
+
+    /* Region being sent and the next page of it, the region is empty when there is none */
+    struct SSD1306_Rect Sending;
+    int Page;
+
+    /* Damage submitted since Sending was picked up, widened to whole pages */
+    struct SSD1306_Rect Queued;
+
+    /*
+     * Display framebuffer as of the last submission, the device may be drawing into a canvas
+     * by the time it is sent so its surface fields are never read from the bus task.
+     */
+    const uint8_t* Framebuffer;
+
+    /* Set while a batch is on the bus, the framebuffer is still being read */
+    bool InFlight;
+
+    /* Bytes the device may still send this round, negative once it went over */
+    int Deficit;
+
+    uint32_t BytesSent;
+    uint32_t Batches;
+};
+
+/*
+ * Owns a bus shared by several displays, for example two panels at 0x3C and 0x3D.
+ *
+ * Tasks hand the bus damaged regions instead of sending them themselves. The bus task
+ * takes turns between devices with work waiting, each turn a device may send
+ * Quantum * Priority bytes. Unused bytes carry over to the next turn while the device
+ * still has work, so a device never gets less than its share however its regions are shaped.
+ * The consecutive pages a device sends in a turn go out as one window.
+ *
+ * While the bus is running only its task may talk to the attached displays,
+ * anything else has to be done between SSD1306_BusLock and SSD1306_BusUnlock.
+ */
+struct SSD1306_Bus {
+    struct SSD1306_BusClient Clients[ SSD1306_BUS_MAX_DEVICES ];
+    int ClientCount;
+
+    /* Bytes added to a device's deficit each turn for every level of priority */
+    int Quantum;
+
+    /* Client whose turn is next */
+    int Next;
+
+    atomic_bool Running;
+
+#if defined ESP_PLATFORM
+    TaskHandle_t Task;
+    SemaphoreHandle_t Stopped;
+
+    /* Protects the clients, held briefly */
+    SemaphoreHandle_t Lock;
+
+    /* Held for every transfer */
+    SemaphoreHandle_t Transfer;
+
+    /* One bit per client, set while it has nothing left to send */
+    EventGroupHandle_t Idle;
+#else
+    pthread_t Thread;
+    pthread_mutex_t Lock;
+    pthread_mutex_t Transfer;
+    pthread_cond_t Wake;
+    pthread_cond_t Idle;
+    bool WakePending;
+#endif
+};
+
+/*
+ * Params:
+ * Bus: Bus object
+ * Quantum: Bytes a priority 1 device may send per turn, a full width page is 128 bytes
+ */
+bool SSD1306_BusInit( struct SSD1306_Bus* Bus, int Quantum );
+
+/*
+ * Params:
+ * DeviceHandle: Initialized display on this bus, not strip rendering
+ * Priority: A priority 2 display gets twice the bytes of a priority 1 one when both are busy
+ */
+bool SSD1306_BusAttach( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle, int Priority );
+
+/*
+ * Starts the task that owns the bus, Core is the CPU to pin it to or -1.
+ * Everything submitted before stopping is sent before SSD1306_BusStop returns.
+ */
+bool SSD1306_BusStart( struct SSD1306_Bus* Bus, int Core );
+void SSD1306_BusStop( struct SSD1306_Bus* Bus );
+
+/*
+ * Queues Region of the display's framebuffer to be sent, NULL for the whole screen.
+ * The framebuffer is read while it is sent, drawing into it before SSD1306_BusWait
+ * returns may show up part way through.
+ */
+void SSD1306_BusUpdateRegion( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Region );
+
+/*
+ * Waits until everything queued for the display has been sent.
+ */
+void SSD1306_BusWait( struct SSD1306_Bus* Bus, struct SSD1306_Device* DeviceHandle );
+
+/*
+ * Keeps the bus task off the bus so displays can be talked to directly,
+ * for example to change the contrast.
+ */
+void SSD1306_BusLock( struct SSD1306_Bus* Bus );
+void SSD1306_BusUnlock( struct SSD1306_Bus* Bus );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_canvas.h"
+#include "ssd1306_displaylist.h"
+
+static void SetFullClip( struct SSD1306_Canvas* Canvas ) {
+    Canvas->Clip.Left = 0;
+    Canvas->Clip.Top = 0;
+    Canvas->Clip.Right = Canvas->Width - 1;
+    Canvas->Clip.Bottom = Canvas->Height - 1;
+}
+
+bool SSD1306_CanvasInit( struct SSD1306_Canvas* Canvas, int Width, int Height, SSD1306_PixelFormat Format ) {
+    const struct SSD1306_PixelOps* PixelOps = NULL;
+
+    NullCheck( Canvas, return false );
+    NullCheck( ( PixelOps = SSD1306_GetPixelOps( Format ) ), return false );
+
+    CheckBounds( Width < 1 || Height < 1, return false );
+    CheckBounds( PixelOps->Depth > 1 && ( Width % 2 ) != 0, return false );
+    CheckBounds( Format == PixelFormat_MonoRow && ( Width % 8 ) != 0, return false );
+
+    memset( Canvas, 0, sizeof( struct SSD1306_Canvas ) );
+
+    Canvas->Width = Width;
+    Canvas->Height = Height;
+    Canvas->BytesPerPage = Width * PixelOps->Depth;
+    Canvas->FramebufferPage = 0;
+    Canvas->FramebufferPages = ( Height + 7 ) / 8;
+    Canvas->PixelFormat = Format;
+
+    NullCheck( ( Canvas->Framebuffer = SSD1306_AllocFramebuffer( Canvas->BytesPerPage * Canvas->FramebufferPages ) ), return false );
+
+    Canvas->Owned = true;
+    SetFullClip( Canvas );
+
+    return true;
+}
+
+void SSD1306_CanvasFree( struct SSD1306_Canvas* Canvas ) {
+    NullCheck( Canvas, return );
+
+    if ( Canvas->Owned == true ) {
+        SSD1306_FreeFramebuffer( Canvas->Framebuffer );
+    }
+
+    Canvas->Framebuffer = NULL;
+    Canvas->Owned = false;
+}
+
+bool SSD1306_CanvasView( struct SSD1306_Canvas* View, const struct SSD1306_Canvas* Parent, const struct SSD1306_Rect* Area ) {
+    const struct SSD1306_PixelOps* PixelOps = NULL;
+    int Column = 0;
+
+    NullCheck( View, return false );
+    NullCheck( Parent, return false );
+    NullCheck( Parent->Framebuffer, return false );
+    NullCheck( Area, return false );
+    NullCheck( ( PixelOps = SSD1306_GetPixelOps( Parent->PixelFormat ) ), return false );
+
+    CheckBounds( Area->Left < 0 || Area->Right >= Parent->Width || Area->Left > Area->Right, return false );
+    CheckBounds( Area->Top < 0 || Area->Bottom >= Parent->Height || Area->Top > Area->Bottom, return false );
+    CheckBounds( ( Area->Top & 0x07 ) != 0, return false );
+    CheckBounds( PixelOps->Depth > 1 && ( ( Area->Left | ( Area->Right + 1 ) ) & 0x01 ) != 0, return false );
+    CheckBounds( Parent->PixelFormat == PixelFormat_MonoRow && ( ( Area->Left | ( Area->Right + 1 ) ) & 0x07 ) != 0, return false );
+
+    /* Only the pages held in the parent's framebuffer can be addressed */
+    CheckBounds( Parent->FramebufferPage != 0 || Parent->FramebufferPages * 8 < Parent->Height, return false );
+
+    memset( View, 0, sizeof( struct SSD1306_Canvas ) );
+
+    /* 1bpp pages hold a byte per column, the other formats are rows of packed pixels */
+    Column = ( Parent->PixelFormat == PixelFormat_Mono ) ? Area->Left : ( Area->Left * PixelOps->Depth ) / 8;
+
+    View->Framebuffer = Parent->Framebuffer + ( ( Area->Top / 8 ) * Parent->BytesPerPage ) + Column;
+    View->Width = ( Area->Right - Area->Left ) + 1;
+    View->Height = ( Area->Bottom - Area->Top ) + 1;
+    View->BytesPerPage = Parent->BytesPerPage;
+    View->FramebufferPage = 0;
+    View->FramebufferPages = ( View->Height + 7 ) / 8;
+    View->PixelFormat = Parent->PixelFormat;
+    View->Owned = false;
+
+    SetFullClip( View );
+    return true;
+}
+
+/*
+ * The surface fields of the device describe whatever is being drawn to,
+ * switching targets swaps them in and out the same way strip rendering does with the band.
+ */
+static void SaveSurface( struct SSD1306_Device* DeviceHandle, struct SSD1306_Canvas* Canvas ) {
+    Canvas->Framebuffer = DeviceHandle->Framebuffer;
+    Canvas->Width = DeviceHandle->Width;
+    Canvas->Height = DeviceHandle->Height;
+    Canvas->BytesPerPage = DeviceHandle->BytesPerPage;
+    Canvas->FramebufferPage = DeviceHandle->FramebufferPage;
+    Canvas->FramebufferPages = DeviceHandle->FramebufferPages;
+    Canvas->PixelFormat = DeviceHandle->PixelFormat;
+    Canvas->Clip = DeviceHandle->Clip;
+    Canvas->Owned = false;
+}
+
+static void LoadSurface( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas ) {
+    DeviceHandle->Framebuffer = Canvas->Framebuffer;
+    DeviceHandle->Width = Canvas->Width;
+    DeviceHandle->Height = Canvas->Height;
+    DeviceHandle->BytesPerPage = Canvas->BytesPerPage;
+    DeviceHandle->FramebufferPage = Canvas->FramebufferPage;
+    DeviceHandle->FramebufferPages = Canvas->FramebufferPages;
+    DeviceHandle->PixelFormat = Canvas->PixelFormat;
+    DeviceHandle->PixelOps = SSD1306_GetPixelOps( Canvas->PixelFormat );
+    DeviceHandle->Clip = Canvas->Clip;
+}
+
+bool SSD1306_GetScreenCanvas( struct SSD1306_Device* DeviceHandle, struct SSD1306_Canvas* Canvas ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+    NullCheck( Canvas, return false );
+
+    if ( DeviceHandle->Target != NULL ) {
+        *Canvas = DeviceHandle->Screen;
+    } else {
+        SaveSurface( DeviceHandle, Canvas );
+    }
+
+    SetFullClip( Canvas );
+    return true;
+}
+
+bool SSD1306_SetTarget( struct SSD1306_Device* DeviceHandle, struct SSD1306_Canvas* Canvas ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    if ( Canvas != NULL ) {
+        NullCheck( Canvas->Framebuffer, return false );
+
+        CheckState( SSD1306_GetPixelOps( Canvas->PixelFormat ) == NULL, return false );
+    }
+
+    if ( DeviceHandle->Target == NULL ) {
+        /*
+         * Only what drawing to the display changes is saved, the size and layout
+         * in Screen are read by background tasks and are never written here.
+         */
+        DeviceHandle->Screen.Framebuffer = DeviceHandle->Framebuffer;
+        DeviceHandle->Screen.FramebufferPage = DeviceHandle->FramebufferPage;
+        DeviceHandle->Screen.FramebufferPages = DeviceHandle->FramebufferPages;
+        DeviceHandle->Screen.Clip = DeviceHandle->Clip;
+        DeviceHandle->ScreenRecorder = DeviceHandle->Recorder;
+    } else {
+        DeviceHandle->Target->Clip = DeviceHandle->Clip;
+    }
+
+    if ( Canvas == NULL ) {
+        LoadSurface( DeviceHandle, &DeviceHandle->Screen );
+        DeviceHandle->Recorder = DeviceHandle->ScreenRecorder;
+    } else {
+        LoadSurface( DeviceHandle, Canvas );
+
+        /* Canvases are never strip rendered, whatever the display records is left alone */
+        DeviceHandle->Recorder = NULL;
+    }
+
+    DeviceHandle->Target = Canvas;
+    return true;
+}
+
+void SSD1306_SetClip( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Clip ) {
+    NullCheck( DeviceHandle, return );
+
+    DeviceHandle->Clip.Left = 0;
+    DeviceHandle->Clip.Top = 0;
+    DeviceHandle->Clip.Right = DeviceHandle->Width - 1;
+    DeviceHandle->Clip.Bottom = DeviceHandle->Height - 1;
+
+    if ( Clip != NULL ) {
+        SSD1306_RectIntersect( &DeviceHandle->Clip, Clip );
+    }
+
+    /* Recorded drawing is replayed later, so the clip has to be replayed along with it */
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecordClip( DeviceHandle );
+    }
+}
+
+static int GetGrayPixel( const struct SSD1306_Canvas* Canvas, int x, int y ) {
+    uint8_t Byte = Canvas->Framebuffer[ ( y * ( Canvas->BytesPerPage / 8 ) ) + ( x >> 1 ) ];
+
+    return ( x & 0x01 ) ? Byte >> 4 : Byte & 0x0F;
+}
+
+static void DrawGrayCanvas( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas, const struct SSD1306_Rect* Source, int x, int y ) {
+    int SourceX = 0;
+    int SourceY = 0;
+
+    /* Clipping is left to SSD1306_DrawPixel */
+    for ( SourceY = Source->Top; SourceY <= Source->Bottom; SourceY++ ) {
+        for ( SourceX = Source->Left; SourceX <= Source->Right; SourceX++ ) {
+            SSD1306_DrawPixel( DeviceHandle, x + ( SourceX - Source->Left ), y + ( SourceY - Source->Top ), SSD_COLOR_GRAY( GetGrayPixel( Canvas, SourceX, SourceY ) ) );
+        }
+    }
+}
+
+void SSD1306_DrawCanvas( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas, const struct SSD1306_Rect* Source, int x, int y, SSD1306_RasterOp Op ) {
+    struct SSD1306_Bitmap Bitmap;
+    struct SSD1306_Rect Area;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Canvas, return );
+    NullCheck( Canvas->Framebuffer, return );
+
+    CheckBounds( Canvas == DeviceHandle->Target, return );
+    CheckBounds( Canvas->FramebufferPage != 0 || Canvas->FramebufferPages * 8 < Canvas->Height, return );
+
+    if ( Canvas->PixelFormat == PixelFormat_Mono || Canvas->PixelFormat == PixelFormat_MonoRow ) {
+        Bitmap.Data = Canvas->Framebuffer;
+        Bitmap.Width = Canvas->Width;
+        Bitmap.Height = Canvas->Height;
+        Bitmap.Format = ( Canvas->PixelFormat == PixelFormat_Mono ) ? BitmapFormat_Page : BitmapFormat_Row;
+        Bitmap.Stride = ( Canvas->PixelFormat == PixelFormat_Mono ) ? Canvas->BytesPerPage : Canvas->BytesPerPage / 8;
+
+        SSD1306_DrawBitmap( DeviceHandle, &Bitmap, Source, x, y, Op );
+        return;
+    }
+
+    CheckBounds( DeviceHandle->PixelFormat != Canvas->PixelFormat, return );
+
+    /* There is no display list command for grayscale pixels */
+    CheckState( DeviceHandle->Recorder != NULL, return );
+
+    Area.Left = 0;
+    Area.Top = 0;
+    Area.Right = Canvas->Width - 1;
+    Area.Bottom = Canvas->Height - 1;
+
+    if ( Source != NULL ) {
+        x+= ( Source->Left < 0 ) ? -Source->Left : 0;
+        y+= ( Source->Top < 0 ) ? -Source->Top : 0;
+
+        SSD1306_RectIntersect( &Area, Source );
+    }
+
+    DrawGrayCanvas( DeviceHandle, Canvas, &Area, x, y );
+}
+
+void SSD1306_FlushCanvas( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas, const struct SSD1306_Rect* Damage ) {
+    struct SSD1306_Rect Area;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Canvas, return );
+
+    CheckState( DeviceHandle->Target != NULL, return );
+
+    Area.Left = 0;
+    Area.Top = 0;
+    Area.Right = ( ( Canvas->Width < DeviceHandle->Width ) ? Canvas->Width : DeviceHandle->Width ) - 1;
+    Area.Bottom = ( ( Canvas->Height < DeviceHandle->Height ) ? Canvas->Height : DeviceHandle->Height ) - 1;
+
+    if ( Damage != NULL ) {
+        SSD1306_RectIntersect( &Area, Damage );
+    }
+
+    if ( SSD1306_RectIsEmpty( &Area ) == true ) {
+        return;
+    }
+
+    SSD1306_DrawCanvas( DeviceHandle, Canvas, &Area, Area.Left, Area.Top, RasterOp_Copy );
+    SSD1306_UpdateRegion( DeviceHandle, &Area );
+}
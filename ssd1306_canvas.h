@@ -0,0 +1,96 @@
+#ifndef _SSD1306_CANVAS_H_
+#define _SSD1306_CANVAS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "ssd1306_bitmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Off-screen drawing.
+ *
+ * Pointing a device at a canvas with SSD1306_SetTarget makes every drawing function
+ * (ssd1306_draw.h, ssd1306_font.h, bitmaps, images and widgets) draw into the canvas
+ * instead of the display, using the canvas size for clipping and layout.
+ * Canvases are drawn into straight away even when the display is strip rendering.
+ *
+ * Updates keep sending the display's own framebuffer while a canvas is the target, and
+ * presenters, gray layers and buses on other tasks carry on since they never look at the
+ * surface fields a canvas is swapped into. Double buffered presents and strip updates
+ * are logged and refused until drawing is pointed back at the display.
+ */
+
+/*
+ * Params:
+ * Canvas: Canvas object
+ * Width, Height: Size in pixels, the width must be even for grayscale formats and a multiple of 8 for PixelFormat_MonoRow
+ * Format: Pixel format, normally that of the display it will be drawn onto
+ *
+ * Returns false if the framebuffer could not be allocated.
+ */
+bool SSD1306_CanvasInit( struct SSD1306_Canvas* Canvas, int Width, int Height, SSD1306_PixelFormat Format );
+void SSD1306_CanvasFree( struct SSD1306_Canvas* Canvas );
+
+/*
+ * Makes View a canvas for the Area part of Parent, drawing to it draws to Parent.
+ * Area must start on a page boundary, and for row major formats its left and right edges must fall between bytes.
+ */
+bool SSD1306_CanvasView( struct SSD1306_Canvas* View, const struct SSD1306_Canvas* Parent, const struct SSD1306_Rect* Area );
+
+/*
+ * Describes the display's own framebuffer as a canvas, for use as a source or view parent.
+ * The framebuffer moves when double buffers are swapped, so fetch it again after presenting.
+ */
+bool SSD1306_GetScreenCanvas( struct SSD1306_Device* DeviceHandle, struct SSD1306_Canvas* Canvas );
+
+/*
+ * Points drawing at Canvas, or back at the display if Canvas is NULL.
+ * The clip rectangle in use is kept with the surface it was set on.
+ * Canvas must stay valid for as long as it is the target.
+ *
+ * Returns false, logged, if the canvas uses a pixel format drawing does not support.
+ */
+bool SSD1306_SetTarget( struct SSD1306_Device* DeviceHandle, struct SSD1306_Canvas* Canvas );
+
+/*
+ * Limits drawing on the current target to Clip, NULL allows the whole surface again.
+ * While recording, such as when strip rendering, the change is recorded along with
+ * the drawing so it still applies when the list is replayed.
+ */
+void SSD1306_SetClip( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Clip );
+
+/*
+ * Draws the Source part of Canvas onto the current target with its top left corner at x, y.
+ *
+ * Params:
+ * Canvas: Canvas to copy from, it must not be the current target
+ * Source: Part of the canvas to draw in canvas coordinates, NULL draws all of it
+ * Op: How 1bpp sources are combined with the target, grayscale sources are always copied
+ *
+ * 1bpp canvases go through SSD1306_DrawBitmap, row major ones are turned into pages 8x8 bits at a time.
+ * Grayscale ones can only be drawn onto grayscale targets and are copied a pixel at a time.
+ *
+ * On a strip rendering display 1bpp canvases are recorded by reference like bitmaps, so they
+ * must be left alone until the frame is sent. Grayscale ones can't be recorded and are logged and refused.
+ */
+void SSD1306_DrawCanvas( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas, const struct SSD1306_Rect* Source, int x, int y, SSD1306_RasterOp Op );
+
+/*
+ * Copies Damage of Canvas into the display's framebuffer at the same place and sends it, NULL for all of it.
+ * Meant for display sized canvases in a layout the display does not use, such as PixelFormat_MonoRow,
+ * only the damaged part is converted.
+ *
+ * A strip rendering display records the canvas as SSD1306_DrawCanvas does and sends the whole frame.
+ * Flushing while a canvas is the target is logged and refused.
+ */
+void SSD1306_FlushCanvas( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Canvas* Canvas, const struct SSD1306_Rect* Damage );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+
+#define COM_Disable_LR_Remap 0
+#define COM_Enable_LR_Remap BIT( 5 )
+
+#define COM_Pins_Sequential 0
+#define COM_Pins_Alternative BIT( 4 )
+
+#define COM_Pins( Pins ) ( COM_Disable_LR_Remap | Pins | BIT( 1 ) )
+
+/*
+ * Every init sequence starts with display off, clock setup and the mux ratio
+ * in this order so the mux ratio can be patched for heights without their own table.
+ * The display is left off, it is switched on once display RAM was cleared.
+ */
+
+/* Init sequence according to SSD1306.pdf */
+#define SSD1306_INIT_SEQUENCE( MuxRatio, COMPins ) { \
+    SSDCmd_Set_Display_Off, \
+    SSDCmd_Set_Display_CLK, 0x80, \
+    SSDCmd_Set_Mux_Ratio, MuxRatio, \
+    SSDCmd_Set_Display_Offset, 0x00, \
+    SSDCmd_Set_Display_Start_Line, \
+    SSDCmd_Set_Display_HFlip_Off, \
+    SSDCmd_Set_COM_Pin_Config, COM_Pins( COMPins ), \
+    SSDCmd_Set_Display_VFlip_Off, \
+    SSDCmd_Set_Contrast, 0x7F, \
+    SSDCmd_Set_Display_Show_RAM, \
+    SSDCmd_Set_Normal_Display, \
+    SSDCmd_Enable_Charge_Pump_Regulator, 0x14, \
+    SSDCmd_Set_Memory_Addressing_Mode, AddressMode_Horizontal \
+}
+
+static const uint8_t SSD1306InitSequence64[ ] = SSD1306_INIT_SEQUENCE( 0x3F, COM_Pins_Alternative );
+static const uint8_t SSD1306InitSequence32[ ] = SSD1306_INIT_SEQUENCE( 0x1F, COM_Pins_Sequential );
+static const uint8_t SSD1306InitSequence16[ ] = SSD1306_INIT_SEQUENCE( 0x0F, COM_Pins_Sequential );
+
+/*
+ * The SH1106 has no addressing mode command, it only knows page addressing.
+ * Its internal DC-DC converter replaces the SSD1306 charge pump.
+ */
+static const uint8_t SH1106InitSequence64[ ] = {
+    SSDCmd_Set_Display_Off,
+    SSDCmd_Set_Display_CLK, 0x80,
+    SSDCmd_Set_Mux_Ratio, 0x3F,
+    SSDCmd_Set_Display_Offset, 0x00,
+    SSDCmd_Set_Display_Start_Line,
+    SSDCmd_Set_Display_HFlip_Off,
+    SSDCmd_Set_COM_Pin_Config, COM_Pins( COM_Pins_Alternative ),
+    SSDCmd_Set_Display_VFlip_Off,
+    SSDCmd_Set_Contrast, 0x7F,
+    SSDCmd_Set_Display_Show_RAM,
+    SSDCmd_Set_Normal_Display,
+    SSDCmd_Set_DCDC, 0x8B
+};
+
+/* The SSD1309 runs from an external panel supply and has no charge pump */
+static const uint8_t SSD1309InitSequence64[ ] = {
+    SSDCmd_Set_Display_Off,
+    SSDCmd_Set_Display_CLK, 0x70,
+    SSDCmd_Set_Mux_Ratio, 0x3F,
+    SSDCmd_Set_Display_Offset, 0x00,
+    SSDCmd_Set_Display_Start_Line,
+    SSDCmd_Set_Display_HFlip_Off,
+    SSDCmd_Set_COM_Pin_Config, COM_Pins( COM_Pins_Alternative ),
+    SSDCmd_Set_Display_VFlip_Off,
+    SSDCmd_Set_Contrast, 0x7F,
+    SSDCmd_Set_Display_Show_RAM,
+    SSDCmd_Set_Normal_Display,
+    SSDCmd_Set_Memory_Addressing_Mode, AddressMode_Horizontal
+};
+
+/* The SSD1305 is told to use an external panel supply through its master configuration */
+#define SSD1305_INIT_SEQUENCE( MuxRatio, COMPins ) { \
+    SSDCmd_Set_Display_Off, \
+    SSDCmd_Set_Display_CLK, 0xF0, \
+    SSDCmd_Set_Mux_Ratio, MuxRatio, \
+    SSDCmd_Set_Display_Offset, 0x00, \
+    SSDCmd_Set_Display_Start_Line, \
+    SSDCmd_Set_Display_HFlip_Off, \
+    SSDCmd_Set_COM_Pin_Config, COM_Pins( COMPins ), \
+    SSDCmd_Set_Display_VFlip_Off, \
+    SSDCmd_Set_Contrast, 0x7F, \
+    SSDCmd_Set_Display_Show_RAM, \
+    SSDCmd_Set_Normal_Display, \
+    SSDCmd_Set_DCDC, 0x8E, \
+    SSDCmd_Set_Memory_Addressing_Mode, AddressMode_Horizontal \
+}
+
+static const uint8_t SSD1305InitSequence64[ ] = SSD1305_INIT_SEQUENCE( 0x3F, COM_Pins_Alternative );
+static const uint8_t SSD1305InitSequence32[ ] = SSD1305_INIT_SEQUENCE( 0x1F, COM_Pins_Sequential );
+
+/*
+ * The SSD1327 drives 128x128 pixels at 4 bits each.
+ * Horizontal address increment with nibble remap so the low nibble is the left pixel.
+ */
+static const uint8_t SSD1327InitSequence128[ ] = {
+    SSDCmd_Set_Display_Off,
+    SSDCmd_Set_Gray_Display_CLK, 0x01,
+    SSDCmd_Set_Mux_Ratio, 0x7F,
+    SSDCmd_Set_Gray_Start_Line, 0x00,
+    SSDCmd_Set_Gray_Display_Offset, 0x00,
+    SSDCmd_Set_Gray_Remap, 0x51,
+    SSDCmd_Set_Gray_Function_Select, 0x01,
+    SSDCmd_Set_Contrast, 0x7F,
+    SSDCmd_Set_Gray_Phase_Length, 0x51,
+    SSDCmd_Set_Gray_Linear_Table,
+    SSDCmd_Set_Gray_Precharge_Voltage, 0x08,
+    SSDCmd_Set_Gray_VCOMH, 0x07,
+    SSDCmd_Set_Gray_Second_Precharge, 0x01,
+    SSDCmd_Set_Gray_Function_Select_B, 0x62,
+    SSDCmd_Set_Display_Show_RAM
+};
+
+#define INIT_SEQUENCE( Height, Sequence ) { Height, Sequence, sizeof( Sequence ) }
+
+static const struct SSD1306_InitSequence SSD1306InitSequences[ ] = {
+    INIT_SEQUENCE( 64, SSD1306InitSequence64 ),
+    INIT_SEQUENCE( 32, SSD1306InitSequence32 ),
+    INIT_SEQUENCE( 16, SSD1306InitSequence16 )
+};
+
+static const struct SSD1306_InitSequence SH1106InitSequences[ ] = {
+    INIT_SEQUENCE( 64, SH1106InitSequence64 )
+};
+
+static const struct SSD1306_InitSequence SSD1309InitSequences[ ] = {
+    INIT_SEQUENCE( 64, SSD1309InitSequence64 )
+};
+
+static const struct SSD1306_InitSequence SSD1305InitSequences[ ] = {
+    INIT_SEQUENCE( 64, SSD1305InitSequence64 ),
+    INIT_SEQUENCE( 32, SSD1305InitSequence32 )
+};
+
+static const struct SSD1306_InitSequence SSD1327InitSequences[ ] = {
+    INIT_SEQUENCE( 128, SSD1327InitSequence128 )
+};
+
+#define ADDRESS_MODES_ALL ( BIT( AddressMode_Horizontal ) | BIT( AddressMode_Vertical ) | BIT( AddressMode_Page ) )
+#define INIT_SEQUENCES( Sequences ) Sequences, sizeof( Sequences ) / sizeof( Sequences[ 0 ] )
+
+static const struct SSD1306_Controller Controllers[ ] = {
+    { Controller_SSD1306, "SSD1306", 128, 0, ADDRESS_MODES_ALL, PixelFormat_Mono, 64, INIT_SEQUENCES( SSD1306InitSequences ) },
+    { Controller_SH1106, "SH1106", 132, 2, BIT( AddressMode_Page ), PixelFormat_Mono, 64, INIT_SEQUENCES( SH1106InitSequences ) },
+    { Controller_SSD1309, "SSD1309", 128, 0, ADDRESS_MODES_ALL, PixelFormat_Mono, 64, INIT_SEQUENCES( SSD1309InitSequences ) },
+    { Controller_SSD1305, "SSD1305", 132, 0, ADDRESS_MODES_ALL, PixelFormat_Mono, 64, INIT_SEQUENCES( SSD1305InitSequences ) },
+    { Controller_SSD1327, "SSD1327", 128, 0, 0, PixelFormat_Gray4, 128, INIT_SEQUENCES( SSD1327InitSequences ) }
+};
+
+const struct SSD1306_Controller* SSD1306_GetController( SSD1306_ControllerType Type ) {
+    size_t i = 0;
+
+    for ( i = 0; i < sizeof( Controllers ) / sizeof( Controllers[ 0 ] ); i++ ) {
+        if ( Controllers[ i ].Type == Type ) {
+            return &Controllers[ i ];
+        }
+    }
+
+    return NULL;
+}
+
+const struct SSD1306_InitSequence* SSD1306_GetInitSequence( const struct SSD1306_Controller* Controller, int Height ) {
+    const struct SSD1306_InitSequence* Best = NULL;
+    int i = 0;
+
+    NullCheck( Controller, return NULL );
+
+    /* The shortest table that still covers Height, its mux ratio gets patched if the height differs */
+    for ( i = 0; i < Controller->InitSequenceCount; i++ ) {
+        if ( Controller->InitSequences[ i ].Height >= Height ) {
+            if ( Best == NULL || Controller->InitSequences[ i ].Height < Best->Height ) {
+                Best = &Controller->InitSequences[ i ];
+            }
+        }
+    }
+
+    return ( Best != NULL ) ? Best : &Controller->InitSequences[ 0 ];
+}
@@ -0,0 +1,650 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_font.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_displaylist.h"
+
+/* Commands are kept 4 byte aligned within the arena */
+#define CmdAlign( Length ) ( ( ( Length ) + 3 ) & ~3 )
+
+static inline int Min( int a, int b ) {
+    return ( a < b ) ? a : b;
+}
+
+static inline int Max( int a, int b ) {
+    return ( a > b ) ? a : b;
+}
+
+static inline const struct SSD1306_DisplayCmd* FirstCmd( const struct SSD1306_DisplayList* List ) {
+    return ( const struct SSD1306_DisplayCmd* ) List->Data;
+}
+
+static inline const struct SSD1306_DisplayCmd* NextCmd( const struct SSD1306_DisplayCmd* Cmd ) {
+    return ( const struct SSD1306_DisplayCmd* ) ( ( const uint8_t* ) Cmd + Cmd->Length );
+}
+
+static inline const char* GetCmdText( const struct SSD1306_DisplayCmd* Cmd ) {
+    return ( const char* ) Cmd + sizeof( struct SSD1306_DisplayCmd ) + sizeof( const struct SSD1306_FontDef* );
+}
+
+static inline const struct SSD1306_FontDef* GetCmdFont( const struct SSD1306_DisplayCmd* Cmd ) {
+    const struct SSD1306_FontDef* Font = NULL;
+
+    memcpy( &Font, ( const uint8_t* ) Cmd + sizeof( struct SSD1306_DisplayCmd ), sizeof( Font ) );
+    return Font;
+}
+
+/*
+ * Bitmap commands carry the source rectangle, the bitmap and optionally its mask.
+ * They are copied in and out since the arena is only 4 byte aligned.
+ */
+static inline uint8_t* GetCmdExtra( const struct SSD1306_DisplayCmd* Cmd ) {
+    return ( uint8_t* ) Cmd + sizeof( struct SSD1306_DisplayCmd );
+}
+
+static void GetCmdBitmap( const struct SSD1306_DisplayCmd* Cmd, struct SSD1306_Rect* Source, struct SSD1306_Bitmap* Bitmap, struct SSD1306_Bitmap* Mask ) {
+    const uint8_t* Extra = GetCmdExtra( Cmd );
+
+    memcpy( Source, Extra, sizeof( struct SSD1306_Rect ) );
+    memcpy( Bitmap, Extra + sizeof( struct SSD1306_Rect ), sizeof( struct SSD1306_Bitmap ) );
+
+    if ( Cmd->Flags & DisplayCmd_Flag_Mask ) {
+        memcpy( Mask, Extra + sizeof( struct SSD1306_Rect ) + sizeof( struct SSD1306_Bitmap ), sizeof( struct SSD1306_Bitmap ) );
+    }
+}
+
+void SSD1306_DisplayListInit( struct SSD1306_DisplayList* List, uint8_t* Data, size_t Size ) {
+    NullCheck( List, return );
+    NullCheck( Data, return );
+
+    memset( List, 0, sizeof( struct SSD1306_DisplayList ) );
+
+    List->Data = Data;
+    List->Size = Size;
+}
+
+void SSD1306_DisplayListReset( struct SSD1306_DisplayList* List ) {
+    NullCheck( List, return );
+
+    /* DrawnHash is kept so an identical frame can be skipped */
+    List->Length = 0;
+    List->Count = 0;
+    List->Overflow = false;
+    List->Indexed = false;
+    List->Hash = 0;
+}
+
+void SSD1306_DisplayListInvalidate( struct SSD1306_DisplayList* List ) {
+    NullCheck( List, return );
+    List->Drawn = false;
+}
+
+static struct SSD1306_DisplayCmd* AllocCmd( struct SSD1306_DisplayList* List, size_t Length ) {
+    struct SSD1306_DisplayCmd* Cmd = NULL;
+
+    Length = CmdAlign( Length );
+
+    if ( Length > UINT16_MAX || List->Length + Length > List->Size ) {
+        ESP_LOGE( __FUNCTION__, "Display list full, dropping command" );
+
+        List->Overflow = true;
+        return NULL;
+    }
+
+    Cmd = ( struct SSD1306_DisplayCmd* ) &List->Data[ List->Length ];
+    memset( Cmd, 0, sizeof( struct SSD1306_DisplayCmd ) );
+
+    Cmd->Length = ( uint16_t ) Length;
+
+    List->Length+= Length;
+    List->Count++;
+    List->Indexed = false;
+
+    return Cmd;
+}
+
+static inline bool CmdIntersects( const struct SSD1306_DisplayCmd* Cmd, const struct SSD1306_Rect* Rect ) {
+    return ( Cmd->Left <= Rect->Right && Cmd->Right >= Rect->Left && Cmd->Top <= Rect->Bottom && Cmd->Bottom >= Rect->Top ) ? true : false;
+}
+
+static void SetCmdBounds( struct SSD1306_DisplayCmd* Cmd, int Left, int Top, int Right, int Bottom ) {
+    Cmd->Left = ( int16_t ) Left;
+    Cmd->Top = ( int16_t ) Top;
+    Cmd->Right = ( int16_t ) Right;
+    Cmd->Bottom = ( int16_t ) Bottom;
+}
+
+bool SSD1306_DisplayListRecord( struct SSD1306_Device* DeviceHandle, SSD1306_DisplayOp Op, int X0, int Y0, int X1, int Y1, int Color, int Flags ) {
+    struct SSD1306_DisplayCmd* Cmd = NULL;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Recorder, return false );
+
+    if ( ( Cmd = AllocCmd( DeviceHandle->Recorder, sizeof( struct SSD1306_DisplayCmd ) ) ) == NULL ) {
+        return false;
+    }
+
+    Cmd->Op = ( uint8_t ) Op;
+    Cmd->Color = ( uint8_t ) Color;
+    Cmd->Flags = ( uint8_t ) Flags;
+    Cmd->X0 = ( int16_t ) X0;
+    Cmd->Y0 = ( int16_t ) Y0;
+    Cmd->X1 = ( int16_t ) X1;
+    Cmd->Y1 = ( int16_t ) Y1;
+
+    switch ( Op ) {
+        case DisplayOp_Clear: {
+            SetCmdBounds( Cmd, 0, 0, DeviceHandle->Width - 1, DeviceHandle->Height - 1 );
+            break;
+        }
+        case DisplayOp_Pixel: {
+            SetCmdBounds( Cmd, X0, Y0, X0, Y0 );
+            break;
+        }
+        case DisplayOp_HLine: {
+            /* X1 is the width of the line */
+            SetCmdBounds( Cmd, Min( X0, X0 + X1 ), Y0, Max( X0, X0 + X1 ), Y0 );
+            break;
+        }
+        case DisplayOp_VLine: {
+            /* X1 is the height of the line */
+            SetCmdBounds( Cmd, X0, Min( Y0, Y0 + X1 ), X0, Max( Y0, Y0 + X1 ) );
+            break;
+        }
+        case DisplayOp_Line:
+        case DisplayOp_Box: {
+            SetCmdBounds( Cmd, Min( X0, X1 ), Min( Y0, Y1 ), Max( X0, X1 ), Max( Y0, Y1 ) );
+            break;
+        }
+        default: {
+            ESP_LOGE( __FUNCTION__, "Invalid display list op %d", Op );
+            break;
+        }
+    };
+
+    return true;
+}
+
+bool SSD1306_DisplayListRecordText( struct SSD1306_Device* DeviceHandle, SSD1306_DisplayOp Op, int x, int y, const char* Text, int TextLength, int Color ) {
+    const struct SSD1306_FontDef* Font = NULL;
+    struct SSD1306_DisplayCmd* Cmd = NULL;
+    uint8_t* Extra = NULL;
+    int Width = 0;
+    int i = 0;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Recorder, return false );
+    NullCheck( ( Font = DeviceHandle->Font ), return false );
+    NullCheck( Text, return false );
+
+    if ( ( Cmd = AllocCmd( DeviceHandle->Recorder, sizeof( struct SSD1306_DisplayCmd ) + sizeof( Font ) + TextLength ) ) == NULL ) {
+        return false;
+    }
+
+    for ( i = 0; i < TextLength; i++ ) {
+        Width+= SSD1306_FontGetCharWidth( DeviceHandle, Text[ i ] );
+    }
+
+    Cmd->Op = ( uint8_t ) Op;
+    Cmd->Color = ( uint8_t ) Color;
+    Cmd->Flags = ( DeviceHandle->FontForceProportional == true ) ? DisplayCmd_Flag_ForceProportional : 0;
+    Cmd->Flags|= ( DeviceHandle->FontForceMonospace == true ) ? DisplayCmd_Flag_ForceMonospace : 0;
+    Cmd->TextLength = ( uint16_t ) TextLength;
+    Cmd->X0 = ( int16_t ) x;
+    Cmd->Y0 = ( int16_t ) y;
+
+    SetCmdBounds( Cmd, x, y, x + Width, y + Font->Height );
+
+    Extra = ( uint8_t* ) Cmd + sizeof( struct SSD1306_DisplayCmd );
+
+    memcpy( Extra, &Font, sizeof( Font ) );
+    memcpy( Extra + sizeof( Font ), Text, TextLength );
+
+    return true;
+}
+
+bool SSD1306_DisplayListRecordBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct SSD1306_Rect* Source, int x, int y, int Op ) {
+    struct SSD1306_DisplayCmd* Cmd = NULL;
+    struct SSD1306_Rect Area = { 0, 0, 0, 0 };
+    uint8_t* Extra = NULL;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Recorder, return false );
+    NullCheck( Bitmap, return false );
+
+    Area.Right = Bitmap->Width - 1;
+    Area.Bottom = Bitmap->Height - 1;
+
+    /* Store the part of the bitmap that is actually drawn so the bounds are exact */
+    if ( Source != NULL ) {
+        x+= ( Source->Left < 0 ) ? -Source->Left : 0;
+        y+= ( Source->Top < 0 ) ? -Source->Top : 0;
+
+        SSD1306_RectIntersect( &Area, Source );
+    }
+
+    if ( SSD1306_RectIsEmpty( &Area ) == true ) {
+        return true;
+    }
+
+    if ( ( Cmd = AllocCmd( DeviceHandle->Recorder, sizeof( struct SSD1306_DisplayCmd ) + sizeof( struct SSD1306_Rect ) + ( sizeof( struct SSD1306_Bitmap ) * ( ( Mask != NULL ) ? 2 : 1 ) ) ) ) == NULL ) {
+        return false;
+    }
+
+    Cmd->Op = ( uint8_t ) DisplayOp_Bitmap;
+    Cmd->Flags = ( Mask != NULL ) ? DisplayCmd_Flag_Mask : 0;
+    Cmd->X0 = ( int16_t ) x;
+    Cmd->Y0 = ( int16_t ) y;
+    Cmd->X1 = ( int16_t ) Op;
+
+    SetCmdBounds( Cmd, x, y, x + ( Area.Right - Area.Left ), y + ( Area.Bottom - Area.Top ) );
+
+    Extra = GetCmdExtra( Cmd );
+
+    memcpy( Extra, &Area, sizeof( Area ) );
+    memcpy( Extra + sizeof( Area ), Bitmap, sizeof( struct SSD1306_Bitmap ) );
+
+    if ( Mask != NULL ) {
+        memcpy( Extra + sizeof( Area ) + sizeof( struct SSD1306_Bitmap ), Mask, sizeof( struct SSD1306_Bitmap ) );
+    }
+
+    return true;
+}
+
+bool SSD1306_DisplayListRecordClip( struct SSD1306_Device* DeviceHandle ) {
+    struct SSD1306_DisplayCmd* Cmd = NULL;
+    const struct SSD1306_Rect* Clip = NULL;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Recorder, return false );
+
+    Clip = &DeviceHandle->Clip;
+
+    /* Replays start out unclipped anyway */
+    if ( DeviceHandle->Recorder->Count == 0 && Clip->Left == 0 && Clip->Top == 0 && Clip->Right == DeviceHandle->Width - 1 && Clip->Bottom == DeviceHandle->Height - 1 ) {
+        return true;
+    }
+
+    if ( ( Cmd = AllocCmd( DeviceHandle->Recorder, sizeof( struct SSD1306_DisplayCmd ) ) ) == NULL ) {
+        return false;
+    }
+
+    Cmd->Op = ( uint8_t ) DisplayOp_Clip;
+    Cmd->X0 = ( int16_t ) Clip->Left;
+    Cmd->Y0 = ( int16_t ) Clip->Top;
+    Cmd->X1 = ( int16_t ) Clip->Right;
+    Cmd->Y1 = ( int16_t ) Clip->Bottom;
+
+    /* Later commands on every page depend on it */
+    SetCmdBounds( Cmd, INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX );
+
+    return true;
+}
+
+/*
+ * Recorded clips are relative to the whole surface, they never widen the clip the replay started with.
+ */
+static void ReplayClip( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayCmd* Cmd, const struct SSD1306_Rect* Outer ) {
+    DeviceHandle->Clip.Left = Cmd->X0;
+    DeviceHandle->Clip.Top = Cmd->Y0;
+    DeviceHandle->Clip.Right = Cmd->X1;
+    DeviceHandle->Clip.Bottom = Cmd->Y1;
+
+    SSD1306_RectIntersect( &DeviceHandle->Clip, Outer );
+}
+
+static void ReplayBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayCmd* Cmd ) {
+    struct SSD1306_Bitmap Bitmap;
+    struct SSD1306_Bitmap Mask;
+    struct SSD1306_Rect Source;
+
+    GetCmdBitmap( Cmd, &Source, &Bitmap, &Mask );
+
+    if ( Cmd->Flags & DisplayCmd_Flag_Mask ) {
+        SSD1306_DrawMaskedBitmap( DeviceHandle, &Bitmap, &Mask, &Source, Cmd->X0, Cmd->Y0 );
+    } else {
+        SSD1306_DrawBitmap( DeviceHandle, &Bitmap, &Source, Cmd->X0, Cmd->Y0, ( SSD1306_RasterOp ) Cmd->X1 );
+    }
+}
+
+static void ReplayText( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayCmd* Cmd ) {
+    const struct SSD1306_FontDef* OldFont = DeviceHandle->Font;
+    bool OldForceProportional = DeviceHandle->FontForceProportional;
+    bool OldForceMonospace = DeviceHandle->FontForceMonospace;
+    const char* Text = GetCmdText( Cmd );
+    int x = Cmd->X0;
+    int i = 0;
+
+    DeviceHandle->Font = GetCmdFont( Cmd );
+    DeviceHandle->FontForceProportional = ( Cmd->Flags & DisplayCmd_Flag_ForceProportional ) ? true : false;
+    DeviceHandle->FontForceMonospace = ( Cmd->Flags & DisplayCmd_Flag_ForceMonospace ) ? true : false;
+
+    /* Text is not NUL terminated inside of the list */
+    for ( i = 0; i < Cmd->TextLength; i++ ) {
+        SSD1306_FontDrawChar( DeviceHandle, Text[ i ], x, Cmd->Y0, Cmd->Color );
+        x+= SSD1306_FontGetCharWidth( DeviceHandle, Text[ i ] );
+    }
+
+    DeviceHandle->Font = OldFont;
+    DeviceHandle->FontForceProportional = OldForceProportional;
+    DeviceHandle->FontForceMonospace = OldForceMonospace;
+}
+
+static void ReplayCmd( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayCmd* Cmd, const struct SSD1306_Rect* Outer ) {
+    switch ( Cmd->Op ) {
+        case DisplayOp_Clear: {
+            SSD1306_Clear( DeviceHandle, Cmd->Color );
+            break;
+        }
+        case DisplayOp_Pixel: {
+            SSD1306_DrawPixel( DeviceHandle, Cmd->X0, Cmd->Y0, Cmd->Color );
+            break;
+        }
+        case DisplayOp_HLine: {
+            SSD1306_DrawHLine( DeviceHandle, Cmd->X0, Cmd->Y0, Cmd->X1, Cmd->Color );
+            break;
+        }
+        case DisplayOp_VLine: {
+            SSD1306_DrawVLine( DeviceHandle, Cmd->X0, Cmd->Y0, Cmd->X1, Cmd->Color );
+            break;
+        }
+        case DisplayOp_Line: {
+            SSD1306_DrawLine( DeviceHandle, Cmd->X0, Cmd->Y0, Cmd->X1, Cmd->Y1, Cmd->Color );
+            break;
+        }
+        case DisplayOp_Box: {
+            SSD1306_DrawBox( DeviceHandle, Cmd->X0, Cmd->Y0, Cmd->X1, Cmd->Y1, Cmd->Color, ( Cmd->Flags & DisplayCmd_Flag_Fill ) ? true : false );
+            break;
+        }
+        case DisplayOp_Char:
+        case DisplayOp_String: {
+            ReplayText( DeviceHandle, Cmd );
+            break;
+        }
+        case DisplayOp_Bitmap: {
+            ReplayBitmap( DeviceHandle, Cmd );
+            break;
+        }
+        case DisplayOp_Clip: {
+            ReplayClip( DeviceHandle, Cmd, Outer );
+            break;
+        }
+        default: break;
+    };
+}
+
+static void ReplayList( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayList* List, const struct SSD1306_Rect* Clip ) {
+    const struct SSD1306_Rect Outer = DeviceHandle->Clip;
+    const struct SSD1306_DisplayCmd* Cmd = NULL;
+    struct SSD1306_Rect Band = {
+        .Left = 0,
+        .Top = DeviceHandle->FramebufferPage * 8,
+        .Right = DeviceHandle->Width - 1,
+        .Bottom = ( ( DeviceHandle->FramebufferPage + DeviceHandle->FramebufferPages ) * 8 ) - 1
+    };
+    int i = 0;
+
+    for ( Cmd = FirstCmd( List ), i = 0; i < List->Count; i++, Cmd = NextCmd( Cmd ) ) {
+        if ( CmdIntersects( Cmd, &Band ) == true && ( Clip == NULL || CmdIntersects( Cmd, Clip ) == true ) ) {
+            ReplayCmd( DeviceHandle, Cmd, &Outer );
+        }
+    }
+
+    DeviceHandle->Clip = Outer;
+}
+
+void SSD1306_DisplayListReplay( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayList* List ) {
+    struct SSD1306_DisplayList* Recorder = NULL;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( List, return );
+
+    /* Do not record what we are replaying */
+    Recorder = DeviceHandle->Recorder;
+    DeviceHandle->Recorder = NULL;
+
+    ReplayList( DeviceHandle, List, NULL );
+
+    DeviceHandle->Recorder = Recorder;
+}
+
+void SSD1306_DisplayListBegin( struct SSD1306_Device* DeviceHandle, struct SSD1306_DisplayList* List ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( List, return );
+
+    SSD1306_DisplayListReset( List );
+
+    List->Parent = DeviceHandle->Recorder;
+    DeviceHandle->Recorder = List;
+
+    /* The list carries the clip it was recorded with */
+    SSD1306_DisplayListRecordClip( DeviceHandle );
+}
+
+/*
+ * FNV-1a, only used to tell whether a list changed between frames.
+ */
+static uint32_t HashCmds( const struct SSD1306_DisplayList* List ) {
+    uint32_t Hash = 2166136261u;
+    size_t i = 0;
+
+    for ( i = 0; i < List->Length; i++ ) {
+        Hash = ( Hash ^ List->Data[ i ] ) * 16777619u;
+    }
+
+    return Hash;
+}
+
+static inline int GetFirstPage( const struct SSD1306_DisplayCmd* Cmd ) {
+    return ( Cmd->Top < 0 ) ? 0 : Cmd->Top / 8;
+}
+
+static inline int GetLastPage( const struct SSD1306_DisplayCmd* Cmd ) {
+    return ( Cmd->Bottom / 8 >= SSD1306_MAX_PAGES ) ? SSD1306_MAX_PAGES - 1 : Cmd->Bottom / 8;
+}
+
+/*
+ * Counting sort of the commands into per page buckets.
+ * Commands keep their recorded order within a bucket so overlapping
+ * and XOR drawing still produce the same result.
+ */
+static void BuildIndex( struct SSD1306_DisplayList* List ) {
+    const struct SSD1306_DisplayCmd* Cmd = NULL;
+    uint16_t Fill[ SSD1306_MAX_PAGES ];
+    uint16_t* Index = NULL;
+    size_t Total = 0;
+    int Page = 0;
+    int i = 0;
+
+    memset( List->PageStart, 0, sizeof( List->PageStart ) );
+    List->Indexed = false;
+
+    if ( List->Overflow == true || List->Length > UINT16_MAX ) {
+        return;
+    }
+
+    for ( Cmd = FirstCmd( List ), i = 0; i < List->Count; i++, Cmd = NextCmd( Cmd ) ) {
+        for ( Page = GetFirstPage( Cmd ); Page <= GetLastPage( Cmd ); Page++ ) {
+            List->PageStart[ Page + 1 ]++;
+            Total++;
+        }
+    }
+
+    if ( List->Length + ( Total * sizeof( uint16_t ) ) > List->Size ) {
+        return;
+    }
+
+    for ( Page = 0; Page < SSD1306_MAX_PAGES; Page++ ) {
+        List->PageStart[ Page + 1 ]+= List->PageStart[ Page ];
+        Fill[ Page ] = List->PageStart[ Page ];
+    }
+
+    Index = ( uint16_t* ) &List->Data[ List->Length ];
+
+    for ( Cmd = FirstCmd( List ), i = 0; i < List->Count; i++, Cmd = NextCmd( Cmd ) ) {
+        for ( Page = GetFirstPage( Cmd ); Page <= GetLastPage( Cmd ); Page++ ) {
+            Index[ Fill[ Page ]++ ] = ( uint16_t ) ( ( const uint8_t* ) Cmd - List->Data );
+        }
+    }
+
+    List->Index = Index;
+    List->Indexed = true;
+}
+
+void SSD1306_DisplayListEnd( struct SSD1306_Device* DeviceHandle ) {
+    struct SSD1306_DisplayList* List = NULL;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( ( List = DeviceHandle->Recorder ), return );
+
+    DeviceHandle->Recorder = List->Parent;
+    List->Parent = NULL;
+
+    BuildIndex( List );
+    List->Hash = HashCmds( List );
+}
+
+/*
+ * Copies all of the commands in List into the active recorder.
+ * Clips recorded in List are narrowed to Clip and the clip in use, which is restored afterwards.
+ */
+static void AppendList( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayList* List, const struct SSD1306_Rect* Clip ) {
+    const struct SSD1306_Rect OldClip = DeviceHandle->Clip;
+    const struct SSD1306_DisplayCmd* Cmd = NULL;
+    struct SSD1306_DisplayCmd* Copy = NULL;
+    struct SSD1306_Rect Narrowed;
+    bool Clipped = false;
+    int i = 0;
+
+    if ( Clip != NULL ) {
+        SSD1306_RectIntersect( &DeviceHandle->Clip, Clip );
+        SSD1306_DisplayListRecordClip( DeviceHandle );
+
+        Clipped = true;
+    }
+
+    for ( Cmd = FirstCmd( List ), i = 0; i < List->Count; i++, Cmd = NextCmd( Cmd ) ) {
+        if ( ( Copy = AllocCmd( DeviceHandle->Recorder, Cmd->Length ) ) == NULL ) {
+            break;
+        }
+
+        memcpy( Copy, Cmd, Cmd->Length );
+
+        if ( Copy->Op == DisplayOp_Clip ) {
+            Narrowed.Left = Copy->X0;
+            Narrowed.Top = Copy->Y0;
+            Narrowed.Right = Copy->X1;
+            Narrowed.Bottom = Copy->Y1;
+
+            SSD1306_RectIntersect( &Narrowed, &DeviceHandle->Clip );
+
+            Copy->X0 = ( int16_t ) Narrowed.Left;
+            Copy->Y0 = ( int16_t ) Narrowed.Top;
+            Copy->X1 = ( int16_t ) Narrowed.Right;
+            Copy->Y1 = ( int16_t ) Narrowed.Bottom;
+
+            Clipped = true;
+        }
+    }
+
+    DeviceHandle->Clip = OldClip;
+
+    /* Whatever follows in the recorder is drawn with the clip it was drawn with before */
+    if ( Clipped == true ) {
+        SSD1306_DisplayListRecordClip( DeviceHandle );
+    }
+}
+
+bool SSD1306_DisplayListDraw( struct SSD1306_Device* DeviceHandle, struct SSD1306_DisplayList* List, const struct SSD1306_Rect* Clip ) {
+    const struct SSD1306_DisplayCmd* Cmd = NULL;
+    struct SSD1306_Rect OldClip;
+    struct SSD1306_Rect Outer;
+    uint8_t* Framebuffer = NULL;
+    int FramebufferPage = 0;
+    int FramebufferPages = 0;
+    int Page = 0;
+    int i = 0;
+
+    NullCheck( DeviceHandle, return false );
+    NullCheck( List, return false );
+
+    /* When recording (strip mode for example) the list becomes part of the outer one */
+    if ( DeviceHandle->Recorder != NULL ) {
+        AppendList( DeviceHandle, List, Clip );
+        return true;
+    }
+
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    /* A clipped draw repaints a dirty area, so it goes ahead even if the list did not change */
+    if ( Clip == NULL && List->Drawn == true && List->DrawnHash == List->Hash ) {
+        return false;
+    }
+
+    /* Culling only skips whole commands, the ones crossing the edge of Clip must not draw past it */
+    OldClip = DeviceHandle->Clip;
+
+    if ( Clip != NULL ) {
+        SSD1306_RectIntersect( &DeviceHandle->Clip, Clip );
+    }
+
+    Outer = DeviceHandle->Clip;
+
+    if ( List->Indexed == false ) {
+        ReplayList( DeviceHandle, List, Clip );
+    } else {
+        Framebuffer = DeviceHandle->Framebuffer;
+        FramebufferPage = DeviceHandle->FramebufferPage;
+        FramebufferPages = DeviceHandle->FramebufferPages;
+
+        /* Narrow the framebuffer down to a single page while its bucket is drawn */
+        for ( Page = FramebufferPage; Page < FramebufferPage + FramebufferPages; Page++ ) {
+            if ( Clip != NULL && ( ( Page * 8 ) + 7 < Clip->Top || ( Page * 8 ) > Clip->Bottom ) ) {
+                continue;
+            }
+
+            DeviceHandle->Framebuffer = Framebuffer + ( ( Page - FramebufferPage ) * DeviceHandle->BytesPerPage );
+            DeviceHandle->FramebufferPage = Page;
+            DeviceHandle->FramebufferPages = 1;
+
+            /* Every bucket replays the recorded clips from the start */
+            DeviceHandle->Clip = Outer;
+
+            for ( i = List->PageStart[ Page ]; i < List->PageStart[ Page + 1 ]; i++ ) {
+                Cmd = ( const struct SSD1306_DisplayCmd* ) &List->Data[ List->Index[ i ] ];
+
+                if ( Clip == NULL || CmdIntersects( Cmd, Clip ) == true ) {
+                    ReplayCmd( DeviceHandle, Cmd, &Outer );
+                }
+            }
+        }
+
+        DeviceHandle->Framebuffer = Framebuffer;
+        DeviceHandle->FramebufferPage = FramebufferPage;
+        DeviceHandle->FramebufferPages = FramebufferPages;
+    }
+
+    DeviceHandle->Clip = OldClip;
+
+    /* Only a full draw leaves the whole list in the framebuffer */
+    if ( Clip == NULL ) {
+        List->DrawnHash = List->Hash;
+        List->Drawn = true;
+    }
+
+    return true;
+}
@@ -0,0 +1,159 @@
+#ifndef _SSD1306_DISPLAYLIST_H_
+#define _SSD1306_DISPLAYLIST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SSD1306_Device;
+struct SSD1306_FontDef;
+struct SSD1306_Bitmap;
+
+typedef enum {
+    DisplayOp_Clear = 0,
+    DisplayOp_Pixel,
+    DisplayOp_HLine,
+    DisplayOp_VLine,
+    DisplayOp_Line,
+    DisplayOp_Box,
+    DisplayOp_Char,
+    DisplayOp_String,
+    DisplayOp_Bitmap,
+    DisplayOp_Clip
+} SSD1306_DisplayOp;
+
+/*
+ * A single recorded drawing call.
+ * Text operations are followed by the font pointer and the
+ * characters themselves, Length covers all of it.
+ * Bitmap operations are followed by the source rectangle, the bitmap
+ * and the mask if there is one, X1 holds the raster op.
+ * Clip operations hold the clip rectangle in X0, Y0, X1, Y1 and are bounded
+ * by the whole surface so that they are never culled.
+ */
+struct SSD1306_DisplayCmd {
+    uint8_t Op;
+    uint8_t Color;
+    uint8_t Flags;
+    uint8_t Reserved;
+    uint16_t Length;
+    uint16_t TextLength;
+
+    /* Arguments as passed to the drawing call */
+    int16_t X0;
+    int16_t Y0;
+    int16_t X1;
+    int16_t Y1;
+
+    /* Bounding box of everything the call can touch, inclusive */
+    int16_t Left;
+    int16_t Top;
+    int16_t Right;
+    int16_t Bottom;
+};
+
+#define DisplayCmd_Flag_Fill BIT( 0 )
+#define DisplayCmd_Flag_ForceProportional BIT( 1 )
+#define DisplayCmd_Flag_ForceMonospace BIT( 2 )
+#define DisplayCmd_Flag_Mask BIT( 3 )
+
+/*
+ * Drawing calls are stored back to back in a caller supplied, 4 byte aligned arena.
+ * If the arena fills up further calls are dropped and Overflow is set.
+ */
+struct SSD1306_DisplayList {
+    uint8_t* Data;
+    size_t Size;
+    size_t Length;
+
+    int Count;
+    bool Overflow;
+
+    /* Recorder that was attached before SSD1306_DisplayListBegin */
+    struct SSD1306_DisplayList* Parent;
+
+    /*
+     * Built by SSD1306_DisplayListEnd in the arena space following the commands.
+     * Index holds command offsets bucketed by display page, the bucket for
+     * page n runs from PageStart[ n ] up to PageStart[ n + 1 ].
+     */
+    const uint16_t* Index;
+    uint16_t PageStart[ SSD1306_MAX_PAGES + 1 ];
+    bool Indexed;
+
+    /* Hash of the recorded commands and of the last ones rasterized */
+    uint32_t Hash;
+    uint32_t DrawnHash;
+    bool Drawn;
+};
+
+void SSD1306_DisplayListInit( struct SSD1306_DisplayList* List, uint8_t* Data, size_t Size );
+void SSD1306_DisplayListReset( struct SSD1306_DisplayList* List );
+
+/*
+ * Records all drawing calls made on DeviceHandle into List until
+ * SSD1306_DisplayListEnd is called. Lists can be nested.
+ */
+void SSD1306_DisplayListBegin( struct SSD1306_Device* DeviceHandle, struct SSD1306_DisplayList* List );
+
+/*
+ * Stops recording, buckets the commands by page and hashes them.
+ */
+void SSD1306_DisplayListEnd( struct SSD1306_Device* DeviceHandle );
+
+/*
+ * Forces the next SSD1306_DisplayListDraw to rasterize the list,
+ * call this if the framebuffer was cleared or drawn over.
+ */
+void SSD1306_DisplayListInvalidate( struct SSD1306_DisplayList* List );
+
+/*
+ * Called by the drawing functions when the device has a recorder attached.
+ * Text is recorded with the font settings that are current at the time of the call.
+ */
+bool SSD1306_DisplayListRecord( struct SSD1306_Device* DeviceHandle, SSD1306_DisplayOp Op, int X0, int Y0, int X1, int Y1, int Color, int Flags );
+bool SSD1306_DisplayListRecordText( struct SSD1306_Device* DeviceHandle, SSD1306_DisplayOp Op, int x, int y, const char* Text, int TextLength, int Color );
+
+/*
+ * Bitmaps are recorded by reference, their data has to stay valid until the list is last drawn.
+ * Changing the data does not change the list, call SSD1306_DisplayListInvalidate to have it redrawn.
+ * Mask is NULL for SSD1306_DrawBitmap, Op is ignored for masked bitmaps.
+ */
+bool SSD1306_DisplayListRecordBitmap( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Bitmap* Bitmap, const struct SSD1306_Bitmap* Mask, const struct SSD1306_Rect* Source, int x, int y, int Op );
+
+/*
+ * Records the device's current clip rectangle, called by SSD1306_SetClip and when recording starts.
+ * When replayed it is narrowed to the clip that was in use when the replay started.
+ * Nothing is recorded for an unclipped surface at the start of a list.
+ */
+bool SSD1306_DisplayListRecordClip( struct SSD1306_Device* DeviceHandle );
+
+/*
+ * Rasterizes the list into the device framebuffer.
+ * Commands which fall entirely outside of the pages held in the framebuffer are skipped.
+ */
+void SSD1306_DisplayListReplay( struct SSD1306_Device* DeviceHandle, const struct SSD1306_DisplayList* List );
+
+/*
+ * Rasterizes a finished list page by page so that each framebuffer page is
+ * only visited once. Drawing is limited to Clip, pass NULL to draw everything.
+ *
+ * The framebuffer is assumed to be retained between frames; if the list
+ * was recorded with exactly the same commands as the last time it was fully drawn
+ * a draw with no Clip does nothing. A clipped draw always repaints Clip, such as
+ * an area that was drawn over, and does not count as drawing the list.
+ *
+ * Returns true if the list was rasterized.
+ */
+bool SSD1306_DisplayListDraw( struct SSD1306_Device* DeviceHandle, struct SSD1306_DisplayList* List, const struct SSD1306_Rect* Clip );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,13 +15,14 @@
 
 #include "ssd1306.h"
 #include "ssd1306_draw.h"
+#include "ssd1306_displaylist.h"
 
 __attribute__( ( always_inline ) ) static inline bool IsPixelVisible( struct SSD1306_Device* DeviceHandle, int x, int y )  {
     bool Result = (
-        ( x >= 0 ) &&
-        ( x < DeviceHandle->Width ) &&
-        ( y >= 0 ) &&
-        ( y < DeviceHandle->Height )
+        ( x >= DeviceHandle->Clip.Left ) &&
+        ( x <= DeviceHandle->Clip.Right ) &&
+        ( y >= DeviceHandle->Clip.Top ) &&
+        ( y <= DeviceHandle->Clip.Bottom )
     ) ? true : false;
 
 #if CONFIG_SSD1306_CLIPDEBUG > 0
@@ -30,7 +31,31 @@ __attribute__( ( always_inline ) ) static inline bool IsPixelVisible( struct SSD
     }
 #endif
 
-    return Result;
+    /* When strip rendering the framebuffer only holds some of the display pages */
+    return Result && ( ( unsigned ) ( ( y >> 3 ) - DeviceHandle->FramebufferPage ) < ( unsigned ) DeviceHandle->FramebufferPages );
+}
+
+/*
+ * Returns the first and last rows held in the framebuffer.
+ */
+__attribute__( ( always_inline ) ) static inline int GetBandTop( struct SSD1306_Device* DeviceHandle ) {
+    return DeviceHandle->FramebufferPage * 8;
+}
+
+__attribute__( ( always_inline ) ) static inline int GetBandBottom( struct SSD1306_Device* DeviceHandle ) {
+    return ( ( DeviceHandle->FramebufferPage + DeviceHandle->FramebufferPages ) * 8 ) - 1;
+}
+
+/*
+ * True if nothing on the surface is clipped away.
+ */
+__attribute__( ( always_inline ) ) static inline bool IsClipFull( struct SSD1306_Device* DeviceHandle ) {
+    return (
+        ( DeviceHandle->Clip.Left == 0 ) &&
+        ( DeviceHandle->Clip.Top == 0 ) &&
+        ( DeviceHandle->Clip.Right == DeviceHandle->Width - 1 ) &&
+        ( DeviceHandle->Clip.Bottom == DeviceHandle->Height - 1 )
+    ) ? true : false;
 }
 
 __attribute__( ( always_inline ) ) static inline void SwapInt( int* a, int* b ) {
@@ -40,19 +65,30 @@ __attribute__( ( always_inline ) ) static inline void SwapInt( int* a, int* b )
     *a = Temp;
 }
 
+/*
+ * 1bpp panels draw gray levels as black or white.
+ */
+__attribute__( ( always_inline ) ) static inline int GetMonoColor( int Color ) {
+    if ( SSD_COLOR_IS_GRAY( Color ) ) {
+        return ( SSD_COLOR_GRAY_LEVEL( Color ) >= 8 ) ? SSD_COLOR_WHITE : SSD_COLOR_BLACK;
+    }
+
+    return Color;
+}
+
 static inline void IRAM_ATTR SSD1306_DrawPixelFast( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color ) {
     uint32_t YBit = ( Y & 0x07 );
     uint8_t* FBOffset = NULL;
 
     /* 
-     * We only need to modify the Y coordinate since the pitch
-     * of the screen is the same as the width.
+     * We only need to modify the Y coordinate since each page
+     * holds one byte per column.
      * Dividing Y by 8 gives us which row the pixel is in but not
      * the bit position.
      */
-    Y>>= 3;
+    Y = ( Y >> 3 ) - DeviceHandle->FramebufferPage;
 
-    FBOffset = DeviceHandle->Framebuffer + ( ( Y * DeviceHandle->Width ) + X );
+    FBOffset = DeviceHandle->Framebuffer + ( ( Y * DeviceHandle->BytesPerPage ) + X );
 
     if ( Color == SSD_COLOR_XOR ) {
         *FBOffset ^= BIT( YBit );
@@ -61,11 +97,438 @@ static inline void IRAM_ATTR SSD1306_DrawPixelFast( struct SSD1306_Device* Devic
     }
 }
 
+/*
+ * Word at a time byte kernels, a word being 32 bits on the ESP32 and usually 64 on a host.
+ * Each byte of a word is handled on its own so the byte order of the machine does not matter.
+ */
+typedef uintptr_t FBWord;
+
+__attribute__( ( always_inline ) ) static inline FBWord ReplicateByte( uint8_t Byte ) {
+    return ( ( ~( FBWord ) 0 ) / 0xFF ) * Byte;
+}
+
+__attribute__( ( always_inline ) ) static inline FBWord LoadWord( const uint8_t* Bytes ) {
+    FBWord Word = 0;
+
+    /* Framebuffer rows are not word aligned, the copy compiles down to a plain load where that is allowed */
+    memcpy( &Word, Bytes, sizeof( FBWord ) );
+    return Word;
+}
+
+__attribute__( ( always_inline ) ) static inline void StoreWord( uint8_t* Bytes, FBWord Word ) {
+    memcpy( Bytes, &Word, sizeof( FBWord ) );
+}
+
+/*
+ * Sets, clears or inverts the bits in Mask of Count bytes.
+ */
+static void IRAM_ATTR MaskBytes( uint8_t* Bytes, int Count, uint8_t Mask, int Color ) {
+    FBWord WordMask = ReplicateByte( Mask );
+    int i = 0;
+
+    if ( Mask == 0xFF && Color != SSD_COLOR_XOR ) {
+        memset( Bytes, ( Color == SSD_COLOR_WHITE ) ? 0xFF : 0x00, Count );
+        return;
+    }
+
+    for ( ; i + ( int ) sizeof( FBWord ) <= Count; i+= sizeof( FBWord ) ) {
+        if ( Color == SSD_COLOR_XOR ) {
+            StoreWord( Bytes + i, LoadWord( Bytes + i ) ^ WordMask );
+        } else if ( Color == SSD_COLOR_WHITE ) {
+            StoreWord( Bytes + i, LoadWord( Bytes + i ) | WordMask );
+        } else {
+            StoreWord( Bytes + i, LoadWord( Bytes + i ) & ~WordMask );
+        }
+    }
+
+    for ( ; i < Count; i++ ) {
+        if ( Color == SSD_COLOR_XOR ) {
+            Bytes[ i ]^= Mask;
+        } else {
+            Bytes[ i ] = ( Color == SSD_COLOR_WHITE ) ? Bytes[ i ] | Mask : Bytes[ i ] & ~Mask;
+        }
+    }
+}
+
+/*
+ * Copies the bits in Mask of Count bytes from Source, which must not overlap Dest.
+ */
+static void IRAM_ATTR CopyMaskedBytes( uint8_t* Dest, const uint8_t* Source, int Count, uint8_t Mask ) {
+    FBWord WordMask = ReplicateByte( Mask );
+    int i = 0;
+
+    if ( Mask == 0xFF ) {
+        memcpy( Dest, Source, Count );
+        return;
+    }
+
+    for ( ; i + ( int ) sizeof( FBWord ) <= Count; i+= sizeof( FBWord ) ) {
+        StoreWord( Dest + i, ( LoadWord( Dest + i ) & ~WordMask ) | ( LoadWord( Source + i ) & WordMask ) );
+    }
+
+    for ( ; i < Count; i++ ) {
+        Dest[ i ] = ( Dest[ i ] & ~Mask ) | ( Source[ i ] & Mask );
+    }
+}
+
+/*
+ * Builds Count page bytes starting Shift rows into the page Upper points at, the rest of each byte
+ * coming from the top of Lower. Either may be NULL when it lies outside the framebuffer, its rows read as 0.
+ */
+static void IRAM_ATTR ShiftPageBytes( uint8_t* Dest, const uint8_t* Upper, const uint8_t* Lower, int Count, int Shift ) {
+    FBWord UpperMask = ReplicateByte( 0xFF >> Shift );
+    FBWord Up = 0;
+    FBWord Low = 0;
+    int i = 0;
+
+    for ( ; i + ( int ) sizeof( FBWord ) <= Count; i+= sizeof( FBWord ) ) {
+        Up = ( Upper != NULL ) ? LoadWord( Upper + i ) : 0;
+        Low = ( Lower != NULL ) ? LoadWord( Lower + i ) : 0;
+
+        /* Bits shifted across from the neighbouring byte are masked off */
+        StoreWord( Dest + i, ( ( Up >> Shift ) & UpperMask ) | ( ( Low << ( 8 - Shift ) ) & ~UpperMask ) );
+    }
+
+    for ( ; i < Count; i++ ) {
+        Up = ( Upper != NULL ) ? Upper[ i ] : 0;
+        Low = ( Lower != NULL ) ? Lower[ i ] : 0;
+
+        Dest[ i ] = ( uint8_t ) ( ( Up >> Shift ) | ( Low << ( 8 - Shift ) ) );
+    }
+}
+
+/*
+ * Bits of page Page covered by rows Top to Bottom.
+ */
+__attribute__( ( always_inline ) ) static inline uint8_t GetPageMask( int Page, int Top, int Bottom ) {
+    uint8_t Mask = 0xFF;
+
+    if ( Top > Page * 8 ) {
+        Mask&= 0xFF << ( Top & 0x07 );
+    }
+
+    if ( Bottom < ( Page * 8 ) + 7 ) {
+        Mask&= 0xFF >> ( 7 - ( Bottom & 0x07 ) );
+    }
+
+    return Mask;
+}
+
+__attribute__( ( always_inline ) ) static inline uint8_t* GetMonoPage( struct SSD1306_Device* DeviceHandle, int Page ) {
+    return DeviceHandle->Framebuffer + ( ( Page - DeviceHandle->FramebufferPage ) * DeviceHandle->BytesPerPage );
+}
+
+/*
+ * 1bpp kernels
+ */
+static void IRAM_ATTR MonoPlot( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color ) {
+    SSD1306_DrawPixelFast( DeviceHandle, X, Y, GetMonoColor( Color ) );
+}
+
+static void IRAM_ATTR MonoHSpan( struct SSD1306_Device* DeviceHandle, int X0, int X1, int Y, int Color ) {
+    if ( X0 <= X1 ) {
+        MaskBytes( GetMonoPage( DeviceHandle, Y >> 3 ) + X0, ( X1 - X0 ) + 1, BIT( Y & 0x07 ), GetMonoColor( Color ) );
+    }
+}
+
+static void IRAM_ATTR MonoVSpan( struct SSD1306_Device* DeviceHandle, int X, int Y0, int Y1, int Color ) {
+    int Page = 0;
+
+    Color = GetMonoColor( Color );
+
+    /* A page byte at a time */
+    for ( Page = Y0 >> 3; Page <= ( Y1 >> 3 ); Page++ ) {
+        MaskBytes( GetMonoPage( DeviceHandle, Page ) + X, 1, GetPageMask( Page, Y0, Y1 ), Color );
+    }
+}
+
+static void MonoFill( struct SSD1306_Device* DeviceHandle, int Color ) {
+    int Page = 0;
+
+    Color = GetMonoColor( Color );
+
+    if ( DeviceHandle->BytesPerPage == DeviceHandle->Width ) {
+        MaskBytes( DeviceHandle->Framebuffer, DeviceHandle->FramebufferPages * DeviceHandle->BytesPerPage, 0xFF, Color );
+        return;
+    }
+
+    /* A view into a wider canvas, the bytes between its pages belong to someone else */
+    for ( Page = 0; Page < DeviceHandle->FramebufferPages; Page++ ) {
+        MaskBytes( DeviceHandle->Framebuffer + ( Page * DeviceHandle->BytesPerPage ), DeviceHandle->Width, 0xFF, Color );
+    }
+}
+
+static void IRAM_ATTR MonoGlyph( struct SSD1306_Device* DeviceHandle, const uint8_t* GlyphData, int ColumnLength, int FirstBit, int X0, int X1, int Y0, int Y1, int Color ) {
+    int Bit = 0;
+    int X = 0;
+    int Y = 0;
+
+    Color = GetMonoColor( Color );
+
+    for ( X = X0; X <= X1; X++, GlyphData+= ColumnLength ) {
+        for ( Y = Y0, Bit = FirstBit; Y <= Y1; Y++, Bit++ ) {
+            if ( GlyphData[ Bit >> 3 ] & BIT( Bit & 0x07 ) ) {
+                SSD1306_DrawPixelFast( DeviceHandle, X, Y, Color );
+            }
+        }
+    }
+}
+
+/*
+ * 4bpp kernels, two pixels per byte with the left one in the low nibble.
+ */
+__attribute__( ( always_inline ) ) static inline int GetGrayLevel( int Color ) {
+    if ( SSD_COLOR_IS_GRAY( Color ) ) {
+        return SSD_COLOR_GRAY_LEVEL( Color );
+    }
+
+    return ( Color == SSD_COLOR_WHITE ) ? 0x0F : 0x00;
+}
+
+/*
+ * Bytes from one row to the next.
+ */
+__attribute__( ( always_inline ) ) static inline int GetGrayPitch( struct SSD1306_Device* DeviceHandle ) {
+    return DeviceHandle->BytesPerPage / 8;
+}
+
+__attribute__( ( always_inline ) ) static inline uint8_t* GetGrayRow( struct SSD1306_Device* DeviceHandle, int Y ) {
+    return DeviceHandle->Framebuffer + ( ( Y - ( DeviceHandle->FramebufferPage * 8 ) ) * GetGrayPitch( DeviceHandle ) );
+}
+
+__attribute__( ( always_inline ) ) static inline void GrayPlotFast( uint8_t* Row, int X, int Color, int Level ) {
+    int Shift = ( X & 0x01 ) * 4;
+    uint8_t* Byte = Row + ( X >> 1 );
+
+    if ( Color == SSD_COLOR_XOR ) {
+        *Byte^= ( 0x0F << Shift );
+    } else {
+        *Byte = ( *Byte & ~( 0x0F << Shift ) ) | ( Level << Shift );
+    }
+}
+
+static void IRAM_ATTR GrayPlot( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color ) {
+    GrayPlotFast( GetGrayRow( DeviceHandle, Y ), X, Color, GetGrayLevel( Color ) );
+}
+
+static void IRAM_ATTR GrayHSpan( struct SSD1306_Device* DeviceHandle, int X0, int X1, int Y, int Color ) {
+    uint8_t* Row = GetGrayRow( DeviceHandle, Y );
+    int Level = GetGrayLevel( Color );
+
+    /* Whole bytes in the middle of the span are filled at once */
+    if ( Color != SSD_COLOR_XOR && X1 - X0 > 2 ) {
+        if ( X0 & 0x01 ) {
+            GrayPlotFast( Row, X0++, Color, Level );
+        }
+
+        if ( ( X1 & 0x01 ) == 0 ) {
+            GrayPlotFast( Row, X1--, Color, Level );
+        }
+
+        memset( Row + ( X0 >> 1 ), ( Level << 4 ) | Level, ( ( X1 - X0 ) + 1 ) >> 1 );
+        return;
+    }
+
+    for ( ; X0 <= X1; X0++ ) {
+        GrayPlotFast( Row, X0, Color, Level );
+    }
+}
+
+static void IRAM_ATTR GrayVSpan( struct SSD1306_Device* DeviceHandle, int X, int Y0, int Y1, int Color ) {
+    uint8_t* Row = GetGrayRow( DeviceHandle, Y0 );
+    int Level = GetGrayLevel( Color );
+
+    for ( ; Y0 <= Y1; Y0++, Row+= GetGrayPitch( DeviceHandle ) ) {
+        GrayPlotFast( Row, X, Color, Level );
+    }
+}
+
+static void GrayFill( struct SSD1306_Device* DeviceHandle, int Color ) {
+    int Level = GetGrayLevel( Color );
+    int Row = 0;
+
+    /* Inverting every level is inverting every bit */
+    if ( Color == SSD_COLOR_XOR ) {
+        for ( Row = 0; Row < DeviceHandle->FramebufferPages * 8; Row++ ) {
+            MaskBytes( DeviceHandle->Framebuffer + ( Row * GetGrayPitch( DeviceHandle ) ), DeviceHandle->Width / 2, 0xFF, Color );
+        }
+
+        return;
+    }
+
+    if ( DeviceHandle->BytesPerPage == DeviceHandle->Width * 4 ) {
+        memset( DeviceHandle->Framebuffer, ( Level << 4 ) | Level, DeviceHandle->FramebufferPages * DeviceHandle->BytesPerPage );
+        return;
+    }
+
+    for ( Row = 0; Row < DeviceHandle->FramebufferPages * 8; Row++ ) {
+        memset( DeviceHandle->Framebuffer + ( Row * GetGrayPitch( DeviceHandle ) ), ( Level << 4 ) | Level, DeviceHandle->Width / 2 );
+    }
+}
+
+static void IRAM_ATTR GrayGlyph( struct SSD1306_Device* DeviceHandle, const uint8_t* GlyphData, int ColumnLength, int FirstBit, int X0, int X1, int Y0, int Y1, int Color ) {
+    int Level = GetGrayLevel( Color );
+    uint8_t* Row = NULL;
+    int Bit = 0;
+    int X = 0;
+    int Y = 0;
+
+    /* Row by row so each framebuffer row is only walked once */
+    for ( Y = Y0, Bit = FirstBit, Row = GetGrayRow( DeviceHandle, Y0 ); Y <= Y1; Y++, Bit++, Row+= GetGrayPitch( DeviceHandle ) ) {
+        for ( X = X0; X <= X1; X++ ) {
+            if ( GlyphData[ ( ( X - X0 ) * ColumnLength ) + ( Bit >> 3 ) ] & BIT( Bit & 0x07 ) ) {
+                GrayPlotFast( Row, X, Color, Level );
+            }
+        }
+    }
+}
+
+/*
+ * 1bpp row major kernels, 8 pixels per byte with the leftmost in bit 0.
+ */
+__attribute__( ( always_inline ) ) static inline int GetRowPitch( struct SSD1306_Device* DeviceHandle ) {
+    return DeviceHandle->BytesPerPage / 8;
+}
+
+__attribute__( ( always_inline ) ) static inline uint8_t* GetMonoRow( struct SSD1306_Device* DeviceHandle, int Y ) {
+    return DeviceHandle->Framebuffer + ( ( Y - ( DeviceHandle->FramebufferPage * 8 ) ) * GetRowPitch( DeviceHandle ) );
+}
+
+__attribute__( ( always_inline ) ) static inline void RowApplyMask( uint8_t* Byte, uint8_t Mask, int Color ) {
+    if ( Color == SSD_COLOR_XOR ) {
+        *Byte^= Mask;
+    } else {
+        *Byte = ( Color == SSD_COLOR_WHITE ) ? *Byte | Mask : *Byte & ~Mask;
+    }
+}
+
+static void IRAM_ATTR RowPlot( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color ) {
+    RowApplyMask( GetMonoRow( DeviceHandle, Y ) + ( X >> 3 ), BIT( X & 0x07 ), GetMonoColor( Color ) );
+}
+
+static void IRAM_ATTR RowHSpan( struct SSD1306_Device* DeviceHandle, int X0, int X1, int Y, int Color ) {
+    uint8_t* Row = GetMonoRow( DeviceHandle, Y );
+    uint8_t FirstMask = 0xFF << ( X0 & 0x07 );
+    uint8_t LastMask = 0xFF >> ( 7 - ( X1 & 0x07 ) );
+    int First = X0 >> 3;
+    int Last = X1 >> 3;
+
+    /* Backwards spans draw nothing, as with the other formats */
+    if ( X0 > X1 ) {
+        return;
+    }
+
+    Color = GetMonoColor( Color );
+
+    if ( First == Last ) {
+        RowApplyMask( Row + First, FirstMask & LastMask, Color );
+        return;
+    }
+
+    RowApplyMask( Row + First, FirstMask, Color );
+    RowApplyMask( Row + Last, LastMask, Color );
+
+    /* The bytes in between are whole */
+    MaskBytes( Row + First + 1, ( Last - First ) - 1, 0xFF, Color );
+}
+
+static void IRAM_ATTR RowVSpan( struct SSD1306_Device* DeviceHandle, int X, int Y0, int Y1, int Color ) {
+    uint8_t* Byte = GetMonoRow( DeviceHandle, Y0 ) + ( X >> 3 );
+    uint8_t Mask = BIT( X & 0x07 );
+
+    Color = GetMonoColor( Color );
+
+    for ( ; Y0 <= Y1; Y0++, Byte+= GetRowPitch( DeviceHandle ) ) {
+        RowApplyMask( Byte, Mask, Color );
+    }
+}
+
+static void RowFill( struct SSD1306_Device* DeviceHandle, int Color ) {
+    int Row = 0;
+
+    Color = GetMonoColor( Color );
+
+    if ( DeviceHandle->BytesPerPage == DeviceHandle->Width ) {
+        MaskBytes( DeviceHandle->Framebuffer, DeviceHandle->FramebufferPages * DeviceHandle->BytesPerPage, 0xFF, Color );
+        return;
+    }
+
+    for ( Row = 0; Row < DeviceHandle->FramebufferPages * 8; Row++ ) {
+        MaskBytes( DeviceHandle->Framebuffer + ( Row * GetRowPitch( DeviceHandle ) ), DeviceHandle->Width / 8, 0xFF, Color );
+    }
+}
+
+static void IRAM_ATTR RowGlyph( struct SSD1306_Device* DeviceHandle, const uint8_t* GlyphData, int ColumnLength, int FirstBit, int X0, int X1, int Y0, int Y1, int Color ) {
+    uint8_t* Row = NULL;
+    int Bit = 0;
+    int X = 0;
+    int Y = 0;
+
+    Color = GetMonoColor( Color );
+
+    /* Row by row so each framebuffer row is only walked once */
+    for ( Y = Y0, Bit = FirstBit, Row = GetMonoRow( DeviceHandle, Y0 ); Y <= Y1; Y++, Bit++, Row+= GetRowPitch( DeviceHandle ) ) {
+        for ( X = X0; X <= X1; X++ ) {
+            if ( GlyphData[ ( ( X - X0 ) * ColumnLength ) + ( Bit >> 3 ) ] & BIT( Bit & 0x07 ) ) {
+                RowApplyMask( Row + ( X >> 3 ), BIT( X & 0x07 ), Color );
+            }
+        }
+    }
+}
+
+static const struct SSD1306_PixelOps MonoOps = {
+    .Plot = MonoPlot,
+    .HSpan = MonoHSpan,
+    .VSpan = MonoVSpan,
+    .Fill = MonoFill,
+    .Glyph = MonoGlyph,
+    .Depth = 1
+};
+
+static const struct SSD1306_PixelOps GrayOps = {
+    .Plot = GrayPlot,
+    .HSpan = GrayHSpan,
+    .VSpan = GrayVSpan,
+    .Fill = GrayFill,
+    .Glyph = GrayGlyph,
+    .Depth = 4
+};
+
+static const struct SSD1306_PixelOps RowOps = {
+    .Plot = RowPlot,
+    .HSpan = RowHSpan,
+    .VSpan = RowVSpan,
+    .Fill = RowFill,
+    .Glyph = RowGlyph,
+    .Depth = 1
+};
+
+const struct SSD1306_PixelOps* SSD1306_GetPixelOps( SSD1306_PixelFormat Format ) {
+    switch ( Format ) {
+        case PixelFormat_Mono: return &MonoOps;
+        case PixelFormat_Gray4: return &GrayOps;
+        case PixelFormat_MonoRow: return &RowOps;
+        default: break;
+    }
+
+    return NULL;
+}
+
 void IRAM_ATTR SSD1306_DrawPixel( struct SSD1306_Device* DeviceHandle, int x, int y, int Color ) {
     NullCheck( DeviceHandle, return );
 
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_Pixel, x, y, 0, 0, Color, 0 );
+        return;
+    }
+
     if ( IsPixelVisible( DeviceHandle, x, y ) == true ) {
-        SSD1306_DrawPixelFast( DeviceHandle, x, y, Color );
+        /* 1bpp is by far the most common so it stays inline */
+        if ( DeviceHandle->PixelFormat == PixelFormat_Mono ) {
+            SSD1306_DrawPixelFast( DeviceHandle, x, y, GetMonoColor( Color ) );
+        } else {
+            DeviceHandle->PixelOps->Plot( DeviceHandle, x, y, Color );
+        }
     }
 }
 
@@ -73,33 +536,68 @@ void IRAM_ATTR SSD1306_DrawHLine( struct SSD1306_Device* DeviceHandle, int x, in
     int XEnd = x + Width;
 
     NullCheck( DeviceHandle, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_HLine, x, y, Width, 0, Color, 0 );
+        return;
+    }
+
     NullCheck( DeviceHandle->Framebuffer, return );
 
-    for ( ; x <= XEnd; x++ ) {
-        if ( IsPixelVisible( DeviceHandle, x, y ) == true ) {
-            SSD1306_DrawPixelFast( DeviceHandle, x, y, Color );
-        } else {
-            break;
-        }
+    /* Clip the whole span up front rather than testing every pixel */
+    if ( XEnd < DeviceHandle->Clip.Left || x > DeviceHandle->Clip.Right || IsPixelVisible( DeviceHandle, DeviceHandle->Clip.Left, y ) == false ) {
+        return;
+    }
+
+    if ( x < DeviceHandle->Clip.Left || XEnd > DeviceHandle->Clip.Right ) {
+        ClipDebug( x, y );
+
+        x = ( x < DeviceHandle->Clip.Left ) ? DeviceHandle->Clip.Left : x;
+        XEnd = ( XEnd > DeviceHandle->Clip.Right ) ? DeviceHandle->Clip.Right : XEnd;
     }
+
+    DeviceHandle->PixelOps->HSpan( DeviceHandle, x, XEnd, y, Color );
 }
 
 void IRAM_ATTR SSD1306_DrawVLine( struct SSD1306_Device* DeviceHandle, int x, int y, int Height, int Color ) {
     int YEnd = y + Height;
 
     NullCheck( DeviceHandle, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_VLine, x, y, Height, 0, Color, 0 );
+        return;
+    }
+
     NullCheck( DeviceHandle->Framebuffer, return );
 
-    for ( ; y <= YEnd; y++ ) {
-        if ( IsPixelVisible( DeviceHandle, x, y ) == true ) {
-            SSD1306_DrawPixel( DeviceHandle, x, y, Color );
-        } else {
-            break;
-        }
+    if ( x < DeviceHandle->Clip.Left || x > DeviceHandle->Clip.Right || YEnd < DeviceHandle->Clip.Top || y > DeviceHandle->Clip.Bottom ) {
+        ClipDebug( x, y );
+        return;
+    }
+
+    if ( y < DeviceHandle->Clip.Top || YEnd > DeviceHandle->Clip.Bottom ) {
+        ClipDebug( x, y );
+
+        y = ( y < DeviceHandle->Clip.Top ) ? DeviceHandle->Clip.Top : y;
+        YEnd = ( YEnd > DeviceHandle->Clip.Bottom ) ? DeviceHandle->Clip.Bottom : YEnd;
+    }
+
+    y = ( y < GetBandTop( DeviceHandle ) ) ? GetBandTop( DeviceHandle ) : y;
+    YEnd = ( YEnd > GetBandBottom( DeviceHandle ) ) ? GetBandBottom( DeviceHandle ) : YEnd;
+
+    if ( y <= YEnd ) {
+        DeviceHandle->PixelOps->VSpan( DeviceHandle, x, y, YEnd, Color );
     }
 }
 
-static inline void IRAM_ATTR DrawWideLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color ) {
+typedef void ( *PlotProc ) ( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color );
+
+/*
+ * The line drawers are always inlined so that each call site gets a copy
+ * specialized for the plot function it passes in.
+ */
+__attribute__( ( always_inline ) ) static inline void DrawWideLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color, PlotProc Plot ) {
     int dx = ( x1 - x0 );
     int dy = ( y1 - y0 );
     int Error = 0;
@@ -116,7 +614,7 @@ static inline void IRAM_ATTR DrawWideLine( struct SSD1306_Device* DeviceHandle,
 
     for ( ; x <= x1; x++ ) {
         if ( IsPixelVisible( DeviceHandle, x, y ) == true ) {
-            SSD1306_DrawPixelFast( DeviceHandle, x, y, Color );
+            Plot( DeviceHandle, x, y, Color );
         }
 
         if ( Error > 0 ) {
@@ -128,7 +626,7 @@ static inline void IRAM_ATTR DrawWideLine( struct SSD1306_Device* DeviceHandle,
     }
 }
 
-static inline void IRAM_ATTR DrawTallLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color ) {
+__attribute__( ( always_inline ) ) static inline void DrawTallLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color, PlotProc Plot ) {
     int dx = ( x1 - x0 );
     int dy = ( y1 - y0 );
     int Error = 0;
@@ -145,7 +643,7 @@ static inline void IRAM_ATTR DrawTallLine( struct SSD1306_Device* DeviceHandle,
 
     for ( ; y < y1; y++ ) {
         if ( IsPixelVisible( DeviceHandle, x, y ) == true ) {
-            SSD1306_DrawPixelFast( DeviceHandle, x, y, Color );
+            Plot( DeviceHandle, x, y, Color );
         }
 
         if ( Error > 0 ) {
@@ -159,6 +657,12 @@ static inline void IRAM_ATTR DrawTallLine( struct SSD1306_Device* DeviceHandle,
 
 void IRAM_ATTR SSD1306_DrawLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color ) {
     NullCheck( DeviceHandle, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_Line, x0, y0, x1, y1, Color, 0 );
+        return;
+    }
+
     NullCheck( DeviceHandle->Framebuffer, return );
 
     if ( x0 == x1 ) {
@@ -173,7 +677,11 @@ void IRAM_ATTR SSD1306_DrawLine( struct SSD1306_Device* DeviceHandle, int x0, in
                 SwapInt( &y0, &y1 );
             }
 
-            DrawWideLine( DeviceHandle, x0, y0, x1, y1, Color );
+            if ( DeviceHandle->PixelFormat == PixelFormat_Mono ) {
+                DrawWideLine( DeviceHandle, x0, y0, x1, y1, GetMonoColor( Color ), SSD1306_DrawPixelFast );
+            } else {
+                DrawWideLine( DeviceHandle, x0, y0, x1, y1, Color, DeviceHandle->PixelOps->Plot );
+            }
         } else {
             /* Tall ( rise > run ) */
             if ( y0 > y1 ) {
@@ -181,7 +689,11 @@ void IRAM_ATTR SSD1306_DrawLine( struct SSD1306_Device* DeviceHandle, int x0, in
                 SwapInt( &x0, &x1 );
             }
 
-            DrawTallLine( DeviceHandle, x0, y0, x1, y1, Color );
+            if ( DeviceHandle->PixelFormat == PixelFormat_Mono ) {
+                DrawTallLine( DeviceHandle, x0, y0, x1, y1, GetMonoColor( Color ), SSD1306_DrawPixelFast );
+            } else {
+                DrawTallLine( DeviceHandle, x0, y0, x1, y1, Color, DeviceHandle->PixelOps->Plot );
+            }
         }
     }
 }
@@ -191,6 +703,12 @@ void IRAM_ATTR SSD1306_DrawBox( struct SSD1306_Device* DeviceHandle, int x1, int
     int Height = ( y2 - y1 );
 
     NullCheck( DeviceHandle, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_Box, x1, y1, x2, y2, Color, ( Fill == true ) ? DisplayCmd_Flag_Fill : 0 );
+        return;
+    }
+
     NullCheck( DeviceHandle->Framebuffer, return );
 
     if ( Fill == false ) {
@@ -206,16 +724,158 @@ void IRAM_ATTR SSD1306_DrawBox( struct SSD1306_Device* DeviceHandle, int x1, int
         /* Right side */
         SSD1306_DrawVLine( DeviceHandle, x1 + Width, y1, Height, Color );
     } else {
-        /* Fill the box by drawing horizontal lines */
-        for ( ; y1 <= y2; y1++ ) {
-            SSD1306_DrawHLine( DeviceHandle, x1, y1, Width, Color );
+        struct SSD1306_Rect Rect = { x1, y1, x2, y2 };
+
+        SSD1306_FillRect( DeviceHandle, &Rect, Color );
+    }
+}
+
+void IRAM_ATTR SSD1306_FillRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Rect, int Color ) {
+    struct SSD1306_Rect Area = { 0, 0, 0, 0 };
+    int Page = 0;
+    int y = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( Rect, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_Box, Rect->Left, Rect->Top, Rect->Right, Rect->Bottom, Color, DisplayCmd_Flag_Fill );
+        return;
+    }
+
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    Area = *Rect;
+    SSD1306_RectIntersect( &Area, &DeviceHandle->Clip );
+
+    Area.Top = ( Area.Top < GetBandTop( DeviceHandle ) ) ? GetBandTop( DeviceHandle ) : Area.Top;
+    Area.Bottom = ( Area.Bottom > GetBandBottom( DeviceHandle ) ) ? GetBandBottom( DeviceHandle ) : Area.Bottom;
+
+    if ( SSD1306_RectIsEmpty( &Area ) == true ) {
+        return;
+    }
+
+    if ( DeviceHandle->PixelFormat != PixelFormat_Mono ) {
+        for ( y = Area.Top; y <= Area.Bottom; y++ ) {
+            DeviceHandle->PixelOps->HSpan( DeviceHandle, Area.Left, Area.Right, y, Color );
+        }
+
+        return;
+    }
+
+    /* Every row of a page is handled by one pass over its bytes, only the top and bottom pages need masking */
+    for ( Page = Area.Top >> 3; Page <= ( Area.Bottom >> 3 ); Page++ ) {
+        MaskBytes( GetMonoPage( DeviceHandle, Page ) + Area.Left, ( Area.Right - Area.Left ) + 1, GetPageMask( Page, Area.Top, Area.Bottom ), GetMonoColor( Color ) );
+    }
+}
+
+void IRAM_ATTR SSD1306_InvertRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Rect ) {
+    SSD1306_FillRect( DeviceHandle, Rect, SSD_COLOR_XOR );
+}
+
+/*
+ * Copies Count columns of destination page Page, Source being the area moved there.
+ */
+static void IRAM_ATTR CopyPage( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Dest, const struct SSD1306_Rect* Source, int Page, int Column, int Count ) {
+    uint8_t Temp[ SSD1306_MAX_COLUMNS ];
+    const uint8_t* Upper = NULL;
+    const uint8_t* Lower = NULL;
+    int SourceColumn = Source->Left + ( Column - Dest->Left );
+    int SourceRow = ( Page * 8 ) - ( Dest->Top - Source->Top );
+    int SourcePage = ( SourceRow < 0 ) ? -1 : SourceRow >> 3;
+    int Shift = SourceRow - ( SourcePage * 8 );
+
+    /* Rows of the page outside the source area come from outside the framebuffer and are masked off */
+    if ( SourcePage >= 0 ) {
+        Upper = GetMonoPage( DeviceHandle, SourcePage ) + SourceColumn;
+    }
+
+    if ( Shift != 0 && SourcePage + 1 < DeviceHandle->FramebufferPages ) {
+        Lower = GetMonoPage( DeviceHandle, SourcePage + 1 ) + SourceColumn;
+    }
+
+    /* Going through Temp lets the source and destination overlap within the page */
+    ShiftPageBytes( Temp, Upper, Lower, Count, Shift );
+    CopyMaskedBytes( GetMonoPage( DeviceHandle, Page ) + Column, Temp, Count, GetPageMask( Page, Dest->Top, Dest->Bottom ) );
+}
+
+void IRAM_ATTR SSD1306_CopyRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Source, int x, int y ) {
+    struct SSD1306_Rect Surface = { 0, 0, 0, 0 };
+    struct SSD1306_Rect From = { 0, 0, 0, 0 };
+    struct SSD1306_Rect To = { 0, 0, 0, 0 };
+    int Columns = 0;
+    int Column = 0;
+    int Count = 0;
+    int Page = 0;
+    int Step = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( Source, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    CheckState( DeviceHandle->Recorder != NULL, return );
+    CheckState( DeviceHandle->PixelFormat != PixelFormat_Mono, return );
+    CheckState( DeviceHandle->FramebufferPage != 0 || DeviceHandle->FramebufferPages * 8 < DeviceHandle->Height, return );
+
+    Surface.Right = DeviceHandle->Width - 1;
+    Surface.Bottom = DeviceHandle->Height - 1;
+
+    /* Clip the source to the surface and the destination to the clip, keeping the two the same size */
+    From = *Source;
+    SSD1306_RectIntersect( &From, &Surface );
+
+    x+= From.Left - Source->Left;
+    y+= From.Top - Source->Top;
+
+    To.Left = x;
+    To.Top = y;
+    To.Right = x + ( From.Right - From.Left );
+    To.Bottom = y + ( From.Bottom - From.Top );
+    SSD1306_RectIntersect( &To, &DeviceHandle->Clip );
+
+    if ( SSD1306_RectIsEmpty( &From ) == true || SSD1306_RectIsEmpty( &To ) == true ) {
+        return;
+    }
+
+    From.Left+= To.Left - x;
+    From.Top+= To.Top - y;
+
+    /*
+     * A page only reads source pages at or above it when moving down and at or below it when moving up,
+     * so walking the pages from the far end means nothing is overwritten before it is read.
+     * Columns are done in chunks the size of the temporary row, walked the same way.
+     */
+    Page = ( To.Top > From.Top ) ? To.Bottom >> 3 : To.Top >> 3;
+    Step = ( To.Top > From.Top ) ? -1 : 1;
+    Columns = ( To.Right - To.Left ) + 1;
+
+    for ( ; Page >= ( To.Top >> 3 ) && Page <= ( To.Bottom >> 3 ); Page+= Step ) {
+        for ( Column = 0; Column < Columns; Column+= Count ) {
+            Count = ( Columns - Column > SSD1306_MAX_COLUMNS ) ? SSD1306_MAX_COLUMNS : Columns - Column;
+
+            if ( To.Left > From.Left ) {
+                CopyPage( DeviceHandle, &To, &From, Page, To.Right - ( Column + Count ) + 1, Count );
+            } else {
+                CopyPage( DeviceHandle, &To, &From, Page, To.Left + Column, Count );
+            }
         }
     }
 }
 
 void SSD1306_Clear( struct SSD1306_Device* DeviceHandle, int Color ) {
     NullCheck( DeviceHandle, return );
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecord( DeviceHandle, DisplayOp_Clear, 0, 0, 0, 0, Color, 0 );
+        return;
+    }
+
     NullCheck( DeviceHandle->Framebuffer, return );
 
-    memset( DeviceHandle->Framebuffer, Color, DeviceHandle->FramebufferSize );
+    /* Whole pages are filled at once unless the clip or a partly used last page leaves some of them alone */
+    if ( IsClipFull( DeviceHandle ) == false || ( DeviceHandle->Height & 0x07 ) != 0 ) {
+        SSD1306_DrawBox( DeviceHandle, DeviceHandle->Clip.Left, DeviceHandle->Clip.Top, DeviceHandle->Clip.Right, DeviceHandle->Clip.Bottom, Color, true );
+        return;
+    }
+
+    DeviceHandle->PixelOps->Fill( DeviceHandle, Color );
 }
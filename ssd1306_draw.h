@@ -38,6 +38,38 @@ extern "C" {
 #define SSD_COLOR_WHITE 1
 #define SSD_COLOR_XOR 2
 
+/*
+ * Intensity from 0 to 15 for grayscale panels.
+ * On 1bpp panels levels 8 and up are white, anything less is black.
+ */
+#define SSD_COLOR_GRAY( Level ) ( 0x10 | ( ( Level ) & 0x0F ) )
+#define SSD_COLOR_IS_GRAY( Color ) ( ( ( Color ) & 0x10 ) != 0 )
+#define SSD_COLOR_GRAY_LEVEL( Color ) ( ( Color ) & 0x0F )
+
+/*
+ * Drawing kernels for one pixel format, picked when the display is initialized.
+ * Coordinates have already been clipped against the clip rectangle and framebuffer band.
+ */
+struct SSD1306_PixelOps {
+    void ( *Plot ) ( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color );
+    void ( *HSpan ) ( struct SSD1306_Device* DeviceHandle, int X0, int X1, int Y, int Color );
+    void ( *VSpan ) ( struct SSD1306_Device* DeviceHandle, int X, int Y0, int Y1, int Color );
+
+    /* Fills the pages held in the framebuffer */
+    void ( *Fill ) ( struct SSD1306_Device* DeviceHandle, int Color );
+
+    /*
+     * Draws glyph columns X0 to X1 rows Y0 to Y1 from column major glyph data,
+     * FirstBit is the glyph row drawn at Y0.
+     */
+    void ( *Glyph ) ( struct SSD1306_Device* DeviceHandle, const uint8_t* GlyphData, int ColumnLength, int FirstBit, int X0, int X1, int Y0, int Y1, int Color );
+
+    /* Bits per pixel */
+    int Depth;
+};
+
+const struct SSD1306_PixelOps* SSD1306_GetPixelOps( SSD1306_PixelFormat Format );
+
 void SSD1306_Clear( struct SSD1306_Device* DeviceHandle, int Color );
 void SSD1306_DrawPixel( struct SSD1306_Device* DeviceHandle, int X, int Y, int Color );
 void SSD1306_DrawHLine( struct SSD1306_Device* DeviceHandle, int x, int y, int Width, int Color );
@@ -45,6 +77,22 @@ void SSD1306_DrawVLine( struct SSD1306_Device* DeviceHandle, int x, int y, int H
 void SSD1306_DrawLine( struct SSD1306_Device* DeviceHandle, int x0, int y0, int x1, int y1, int Color );
 void SSD1306_DrawBox( struct SSD1306_Device* DeviceHandle, int x1, int y1, int x2, int y2, int Color, bool Fill );
 
+/*
+ * Fills Rect with Color, SSD_COLOR_XOR inverts it, such as for a selected menu row.
+ * 1bpp framebuffers are filled a page and a word at a time rather than a pixel at a time.
+ */
+void SSD1306_FillRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Rect, int Color );
+void SSD1306_InvertRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Rect );
+
+/*
+ * Moves the pixels in Source so its top left ends up at x, y, the two may overlap.
+ * What Source leaves behind is not cleared.
+ *
+ * 1bpp only, not while recording or strip rendering, otherwise the call is logged and ignored.
+ * Only the destination is clipped against the clip rectangle.
+ */
+void SSD1306_CopyRect( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Source, int x, int y );
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,4 +41,17 @@
     }
 #endif
 
+/*
+ * For calls that are valid but can't be done in the current state, such as while
+ * recording or strip rendering. They are logged and refused but never abort.
+ */
+#if ! defined CheckState
+    #define CheckState( expr, retexpr ) { \
+        if ( expr ) { \
+            ESP_LOGW( __FUNCTION__, "Line %d: Refused, %s", __LINE__, #expr ); \
+            retexpr; \
+        } \
+    }
+#endif
+
 #endif
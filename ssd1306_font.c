@@ -12,6 +12,7 @@
 #include "ssd1306.h"
 #include "ssd1306_draw.h"
 #include "ssd1306_font.h"
+#include "ssd1306_displaylist.h"
 
 static int RoundUpFontHeight( const struct SSD1306_FontDef* Font ) {
     int Height = Font->Height;
@@ -38,12 +39,16 @@ void SSD1306_FontDrawChar( struct SSD1306_Device* DisplayHandle, char Character,
     int CharEndY = 0;
     int OffsetX = 0;
     int OffsetY = 0;
-    int YByte = 0;
-    int YBit = 0;
-    int i = 0;
+    int BandTop = 0;
+    int BandBottom = 0;
 
     NullCheck( DisplayHandle, return );
     NullCheck( DisplayHandle->Font, return );
+
+    if ( DisplayHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecordText( DisplayHandle, DisplayOp_Char, x, y, &Character, 1, Color );
+        return;
+    }
     
     NullCheck( ( GlyphData = GetCharPtr( DisplayHandle->Font, Character ) ), return );
 
@@ -61,11 +66,18 @@ void SSD1306_FontDrawChar( struct SSD1306_Device* DisplayHandle, char Character,
         CharEndX = CharStartX + CharWidth;
         CharEndY = CharStartY + CharHeight;
 
-        /* If the character is partially offscreen offset the end by
-        * distance between (coord) and 0.
+        /* If the character is partially clipped offset the start by
+        * distance between (coord) and the clip rectangle.
+        * Rows outside of the pages held in the framebuffer are skipped the same way.
         */
-        OffsetX = ( CharStartX < 0 ) ? abs( CharStartX ) : 0;
-        OffsetY = ( CharStartY < 0 ) ? abs( CharStartY ) : 0;
+        BandTop = DisplayHandle->FramebufferPage * 8;
+        BandBottom = ( DisplayHandle->FramebufferPage + DisplayHandle->FramebufferPages ) * 8;
+
+        BandTop = ( BandTop < DisplayHandle->Clip.Top ) ? DisplayHandle->Clip.Top : BandTop;
+        BandBottom = ( BandBottom > DisplayHandle->Clip.Bottom + 1 ) ? DisplayHandle->Clip.Bottom + 1 : BandBottom;
+
+        OffsetX = ( CharStartX < DisplayHandle->Clip.Left ) ? DisplayHandle->Clip.Left - CharStartX : 0;
+        OffsetY = ( CharStartY < BandTop ) ? BandTop - CharStartY : 0;
 
         /* This skips into the proper column within the glyph data */
         GlyphData+= ( OffsetX * GlyphColumnLen );
@@ -73,27 +85,18 @@ void SSD1306_FontDrawChar( struct SSD1306_Device* DisplayHandle, char Character,
         CharStartX+= OffsetX;
         CharStartY+= OffsetY;
 
-        /* Do not attempt to draw if this character is entirely offscreen */
-        if ( CharEndX < 0 || CharStartX >= DisplayHandle->Width || CharEndY < 0 || CharStartY >= DisplayHandle->Height ) {
+        /* Do not attempt to draw if this character is entirely clipped */
+        if ( CharEndX <= DisplayHandle->Clip.Left || CharStartX > DisplayHandle->Clip.Right || CharEndY <= DisplayHandle->Clip.Top || CharStartY > DisplayHandle->Clip.Bottom ) {
             ClipDebug( x, y );
             return;
         }
 
-        /* Do not attempt to draw past the end of the screen */
-        CharEndX = ( CharEndX >= DisplayHandle->Width ) ? DisplayHandle->Width - 1 : CharEndX;
-        CharEndY = ( CharEndY >= DisplayHandle->Height ) ? DisplayHandle->Height - 1 : CharEndY;
+        /* Do not attempt to draw past the end of the clip rectangle or framebuffer */
+        CharEndX = ( CharEndX > DisplayHandle->Clip.Right + 1 ) ? DisplayHandle->Clip.Right + 1 : CharEndX;
+        CharEndY = ( CharEndY > BandBottom ) ? BandBottom : CharEndY;
 
-        for ( x = CharStartX; x < CharEndX; x++ ) {
-            for ( y = CharStartY, i = 0; y < CharEndY && i < CharHeight; y++, i++ ) {
-                YByte = ( i + OffsetY ) / 8;
-                YBit = ( i + OffsetY ) & 0x07;
-
-                if ( GlyphData[ YByte ] & BIT( YBit ) ) {
-                    SSD1306_DrawPixel( DisplayHandle, x, y, Color );
-                }            
-            }
-
-            GlyphData+= GlyphColumnLen;
+        if ( CharStartX < CharEndX && CharStartY < CharEndY ) {
+            DisplayHandle->PixelOps->Glyph( DisplayHandle, GlyphData, GlyphColumnLen, OffsetY, CharStartX, CharEndX - 1, CharStartY, CharEndY - 1, Color );
         }
     }
 }
@@ -207,6 +210,11 @@ void SSD1306_FontDrawString( struct SSD1306_Device* Display, int x, int y, const
     NullCheck( Display->Font, return );
     NullCheck( Text, return );
 
+    if ( Display->Recorder != NULL ) {
+        SSD1306_DisplayListRecordText( Display, DisplayOp_String, x, y, Text, strlen( Text ), Color );
+        return;
+    }
+
     for ( Len = strlen( Text ), i = 0; i < Len; i++ ) {
         SSD1306_FontDrawChar( Display, *Text, x, y, Color );
 
@@ -0,0 +1,430 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#if ! defined ESP_PLATFORM && defined __linux__
+/* For pthread_setaffinity_np */
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_gray.h"
+
+#if defined ESP_PLATFORM
+static const int GrayStackSize = CONFIG_SSD1306_GRAY_STACK_SIZE;
+static const int GrayPriority = CONFIG_SSD1306_GRAY_PRIORITY;
+#endif
+
+static int64_t GetTimeUs( void ) {
+#if defined ESP_PLATFORM
+    return esp_timer_get_time( );
+#else
+    struct timespec Now;
+
+    clock_gettime( CLOCK_MONOTONIC, &Now );
+    return ( ( int64_t ) Now.tv_sec * 1000000 ) + ( Now.tv_nsec / 1000 );
+#endif
+}
+
+static void ShowPlane( struct SSD1306_GrayLayer* Layer, int Plane ) {
+    struct SSD1306_Device* DeviceHandle = Layer->Device;
+    int64_t Start = GetTimeUs( );
+
+    SSD1306_WriteWindow( DeviceHandle, Layer->Planes[ Layer->Consumer ][ Plane ], 0, DeviceHandle->Screen.Width - 1, 0, ( DeviceHandle->Screen.Height / 8 ) - 1 );
+
+    atomic_store( &Layer->FlushUs, ( int ) ( GetTimeUs( ) - Start ) );
+    atomic_fetch_add( &Layer->PlanesShown, 1 );
+}
+
+/*
+ * Called once per slot, Missed is the number of slots that went by while the previous one was busy.
+ * Slot 0 starts a cycle with the high plane which stays up during slot 1, slot 2 shows the low plane.
+ */
+static void RunSlot( struct SSD1306_GrayLayer* Layer, unsigned int Missed ) {
+    unsigned int Pending = 0;
+
+    if ( Missed > 0 ) {
+        atomic_fetch_add( &Layer->SlotsMissed, Missed );
+    }
+
+    Layer->Slot = ( Layer->Slot + 1 + Missed ) % SSD1306_GRAY_SLOTS_PER_CYCLE;
+
+    switch ( Layer->Slot ) {
+        case 0: {
+            /* Our old set becomes the pending one, it is stale so it is not marked fresh */
+            if ( ( atomic_load( &Layer->Pending ) & Gray_Fresh ) != 0 ) {
+                Pending = atomic_exchange( &Layer->Pending, ( unsigned int ) Layer->Consumer );
+                Layer->Consumer = Pending & ~Gray_Fresh;
+            }
+
+            ShowPlane( Layer, 1 );
+            break;
+        }
+        case 2: {
+            ShowPlane( Layer, 0 );
+            break;
+        }
+        default: break;
+    }
+}
+
+#if defined ESP_PLATFORM
+
+static void IRAM_ATTR SlotTimer( void* Param ) {
+    xTaskNotifyGive( ( ( struct SSD1306_GrayLayer* ) Param )->Task );
+}
+
+static void GrayTask( void* Param ) {
+    struct SSD1306_GrayLayer* Layer = ( struct SSD1306_GrayLayer* ) Param;
+    uint32_t Slots = 0;
+
+    while ( atomic_load( &Layer->Running ) == true ) {
+        /* Each notification is a slot, more than one means we fell behind */
+        if ( ( Slots = ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) ) > 0 && atomic_load( &Layer->Running ) == true ) {
+            RunSlot( Layer, Slots - 1 );
+        }
+    }
+
+    xSemaphoreGive( Layer->Stopped );
+    vTaskDelete( NULL );
+}
+
+static bool StartTask( struct SSD1306_GrayLayer* Layer, int Core ) {
+    const esp_timer_create_args_t TimerArgs = {
+        .callback = SlotTimer,
+        .arg = Layer,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "ssd1306_gray"
+    };
+
+    NullCheck( ( Layer->Stopped = xSemaphoreCreateBinary( ) ), return false );
+
+    if ( xTaskCreatePinnedToCore( GrayTask, "ssd1306_gray", GrayStackSize, Layer, GrayPriority, &Layer->Task, ( Core < 0 ) ? tskNO_AFFINITY : Core ) != pdPASS ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create gray layer task" );
+
+        vSemaphoreDelete( Layer->Stopped );
+        return false;
+    }
+
+    if ( esp_timer_create( &TimerArgs, &Layer->Timer ) != ESP_OK || esp_timer_start_periodic( Layer->Timer, Layer->SlotUs ) != ESP_OK ) {
+        ESP_LOGE( __FUNCTION__, "Failed to start gray layer timer" );
+
+        atomic_store( &Layer->Running, false );
+        xTaskNotifyGive( Layer->Task );
+        xSemaphoreTake( Layer->Stopped, portMAX_DELAY );
+
+        esp_timer_delete( Layer->Timer );
+        vSemaphoreDelete( Layer->Stopped );
+        return false;
+    }
+
+    return true;
+}
+
+static void JoinTask( struct SSD1306_GrayLayer* Layer ) {
+    esp_timer_stop( Layer->Timer );
+    esp_timer_delete( Layer->Timer );
+
+    xTaskNotifyGive( Layer->Task );
+    xSemaphoreTake( Layer->Stopped, portMAX_DELAY );
+    vSemaphoreDelete( Layer->Stopped );
+}
+
+#else
+
+/*
+ * POSIX backend, sleeps until the start of each slot.
+ */
+static void* GrayThread( void* Param ) {
+    struct SSD1306_GrayLayer* Layer = ( struct SSD1306_GrayLayer* ) Param;
+    struct timespec Deadline;
+    int64_t Next = GetTimeUs( );
+    int64_t Late = 0;
+
+    while ( atomic_load( &Layer->Running ) == true ) {
+        Next+= Layer->SlotUs;
+        Late = GetTimeUs( ) - Next;
+
+        if ( Late < 0 ) {
+            Deadline.tv_sec = Next / 1000000;
+            Deadline.tv_nsec = ( Next % 1000000 ) * 1000;
+
+            clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL );
+            Late = 0;
+        }
+
+        Next+= ( Late / Layer->SlotUs ) * Layer->SlotUs;
+        RunSlot( Layer, ( unsigned int ) ( Late / Layer->SlotUs ) );
+    }
+
+    return NULL;
+}
+
+static bool StartTask( struct SSD1306_GrayLayer* Layer, int Core ) {
+#if defined __linux__
+    cpu_set_t CPUSet;
+#endif
+
+    if ( pthread_create( &Layer->Thread, NULL, GrayThread, Layer ) != 0 ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create gray layer thread" );
+        return false;
+    }
+
+#if defined __linux__
+    if ( Core >= 0 ) {
+        CPU_ZERO( &CPUSet );
+        CPU_SET( Core, &CPUSet );
+
+        pthread_setaffinity_np( Layer->Thread, sizeof( CPUSet ), &CPUSet );
+    }
+#endif
+
+    return true;
+}
+
+static void JoinTask( struct SSD1306_GrayLayer* Layer ) {
+    pthread_join( Layer->Thread, NULL );
+}
+
+#endif
+
+static void FreeLayer( struct SSD1306_GrayLayer* Layer ) {
+    int i = 0;
+
+    SSD1306_FreeFramebuffer( ( uint8_t* ) Layer->Canvas );
+
+    for ( i = 0; i < 3; i++ ) {
+        SSD1306_FreeFramebuffer( Layer->Planes[ i ][ 0 ] );
+        SSD1306_FreeFramebuffer( Layer->Planes[ i ][ 1 ] );
+    }
+
+    Layer->Canvas = NULL;
+    Layer->Device = NULL;
+}
+
+bool SSD1306_GrayStart( struct SSD1306_GrayLayer* Layer, struct SSD1306_Device* DeviceHandle, int SlotUs, int Core ) {
+    int i = 0;
+
+    NullCheck( Layer, return false );
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckBounds( DeviceHandle->PixelFormat != PixelFormat_Mono, return false );
+    CheckBounds( DeviceHandle->StripPages > 0, return false );
+    CheckBounds( SlotUs <= 0, return false );
+
+    memset( Layer, 0, sizeof( struct SSD1306_GrayLayer ) );
+
+    Layer->Device = DeviceHandle;
+    Layer->SlotUs = SlotUs;
+    Layer->Canvas = ( uint16_t* ) SSD1306_AllocFramebuffer( DeviceHandle->FramebufferSize * 2 );
+
+    for ( i = 0; i < 3; i++ ) {
+        Layer->Planes[ i ][ 0 ] = SSD1306_AllocFramebuffer( DeviceHandle->FramebufferSize );
+        Layer->Planes[ i ][ 1 ] = SSD1306_AllocFramebuffer( DeviceHandle->FramebufferSize );
+
+        if ( Layer->Planes[ i ][ 0 ] == NULL || Layer->Planes[ i ][ 1 ] == NULL ) {
+            break;
+        }
+    }
+
+    if ( Layer->Canvas == NULL || i < 3 ) {
+        ESP_LOGE( __FUNCTION__, "Failed to allocate gray layer buffers" );
+
+        FreeLayer( Layer );
+        return false;
+    }
+
+    Layer->Producer = 0;
+    Layer->Consumer = 1;
+    Layer->Slot = SSD1306_GRAY_SLOTS_PER_CYCLE - 1;
+
+    atomic_init( &Layer->Pending, 2 );
+    atomic_init( &Layer->Running, true );
+    atomic_init( &Layer->PlanesShown, 0 );
+    atomic_init( &Layer->SlotsMissed, 0 );
+    atomic_init( &Layer->Commits, 0 );
+    atomic_init( &Layer->FlushUs, 0 );
+
+    /* A plane has to go out well within its slot or the levels turn into flicker */
+    ShowPlane( Layer, 1 );
+
+    if ( atomic_load( &Layer->FlushUs ) >= SlotUs ) {
+        ESP_LOGE( __FUNCTION__, "A frame takes %dus to send, more than a %dus slot", atomic_load( &Layer->FlushUs ), SlotUs );
+
+        FreeLayer( Layer );
+        return false;
+    }
+
+    atomic_store( &Layer->PlanesShown, 0 );
+    Layer->StartedUs = GetTimeUs( );
+
+    if ( StartTask( Layer, Core ) == false ) {
+        FreeLayer( Layer );
+        return false;
+    }
+
+    return true;
+}
+
+void SSD1306_GrayStop( struct SSD1306_GrayLayer* Layer ) {
+    NullCheck( Layer, return );
+    NullCheck( Layer->Device, return );
+
+    atomic_store( &Layer->Running, false );
+    JoinTask( Layer );
+
+    ShowPlane( Layer, 1 );
+    FreeLayer( Layer );
+}
+
+void SSD1306_GrayDrawPixel( struct SSD1306_GrayLayer* Layer, int X, int Y, int Level ) {
+    uint16_t* Column = NULL;
+    int Shift = 0;
+
+    NullCheck( Layer, return );
+    NullCheck( Layer->Canvas, return );
+
+    CheckBounds( Level < 0 || Level >= SSD1306_GRAY_LEVELS, return );
+
+    if ( X < 0 || X >= Layer->Device->Screen.Width || Y < 0 || Y >= Layer->Device->Screen.Height ) {
+        ClipDebug( X, Y );
+        return;
+    }
+
+    Column = &Layer->Canvas[ ( ( Y >> 3 ) * Layer->Device->Screen.Width ) + X ];
+    Shift = ( Y & 0x07 ) * 2;
+
+    *Column = ( *Column & ~( 0x03 << Shift ) ) | ( Level << Shift );
+}
+
+void SSD1306_GrayFillBox( struct SSD1306_GrayLayer* Layer, int X0, int Y0, int X1, int Y1, int Level ) {
+    uint16_t* Column = NULL;
+    uint16_t Pattern = 0;
+    uint16_t Mask = 0;
+    int Width = 0;
+    int Page = 0;
+    int Top = 0;
+    int Bottom = 0;
+    int X = 0;
+
+    NullCheck( Layer, return );
+    NullCheck( Layer->Canvas, return );
+
+    CheckBounds( Level < 0 || Level >= SSD1306_GRAY_LEVELS, return );
+
+    Width = Layer->Device->Screen.Width;
+
+    X0 = ( X0 < 0 ) ? 0 : X0;
+    Y0 = ( Y0 < 0 ) ? 0 : Y0;
+    X1 = ( X1 >= Width ) ? Width - 1 : X1;
+    Y1 = ( Y1 >= Layer->Device->Screen.Height ) ? Layer->Device->Screen.Height - 1 : Y1;
+
+    /* Level repeated for all 8 pixels of a column */
+    Pattern = Level * 0x5555;
+
+    for ( Page = Y0 / 8; X0 <= X1 && Page <= Y1 / 8; Page++ ) {
+        Top = ( Page == Y0 / 8 ) ? Y0 & 0x07 : 0;
+        Bottom = ( Page == Y1 / 8 ) ? Y1 & 0x07 : 7;
+
+        Mask = ( uint16_t ) ( ( 0xFFFF << ( Top * 2 ) ) & ( 0xFFFF >> ( ( 7 - Bottom ) * 2 ) ) );
+        Column = &Layer->Canvas[ ( Page * Width ) + X0 ];
+
+        for ( X = X0; X <= X1; X++, Column++ ) {
+            *Column = ( *Column & ~Mask ) | ( Pattern & Mask );
+        }
+    }
+}
+
+void SSD1306_GrayClear( struct SSD1306_GrayLayer* Layer, int Level ) {
+    NullCheck( Layer, return );
+    NullCheck( Layer->Device, return );
+
+    SSD1306_GrayFillBox( Layer, 0, 0, Layer->Device->Screen.Width - 1, Layer->Device->Screen.Height - 1, Level );
+}
+
+/*
+ * Gathers the even bits of each 16 bit half into its low byte and the odd bits into its high byte.
+ */
+static inline uint32_t Unzip( uint32_t Word ) {
+    uint32_t Swap = 0;
+
+    Swap = ( Word ^ ( Word >> 1 ) ) & 0x22222222;
+    Word^= Swap ^ ( Swap << 1 );
+
+    Swap = ( Word ^ ( Word >> 2 ) ) & 0x0C0C0C0C;
+    Word^= Swap ^ ( Swap << 2 );
+
+    Swap = ( Word ^ ( Word >> 4 ) ) & 0x00F000F0;
+    Word^= Swap ^ ( Swap << 4 );
+
+    return Word;
+}
+
+/*
+ * Two columns at a time, the low bit of every pixel goes to the low plane and the high bit to the high one.
+ */
+static void SplitPlanes( const uint16_t* Canvas, uint8_t* Low, uint8_t* High, int Count ) {
+    uint32_t Word = 0;
+    int i = 0;
+
+    for ( i = 0; i + 1 < Count; i+= 2 ) {
+        Word = Unzip( ( uint32_t ) Canvas[ i ] | ( ( uint32_t ) Canvas[ i + 1 ] << 16 ) );
+
+        Low[ i ] = Word & 0xFF;
+        High[ i ] = ( Word >> 8 ) & 0xFF;
+        Low[ i + 1 ] = ( Word >> 16 ) & 0xFF;
+        High[ i + 1 ] = Word >> 24;
+    }
+
+    if ( i < Count ) {
+        Word = Unzip( Canvas[ i ] );
+
+        Low[ i ] = Word & 0xFF;
+        High[ i ] = ( Word >> 8 ) & 0xFF;
+    }
+}
+
+void SSD1306_GrayCommit( struct SSD1306_GrayLayer* Layer ) {
+    unsigned int Previous = 0;
+    int Submitted = 0;
+
+    NullCheck( Layer, return );
+    NullCheck( Layer->Canvas, return );
+
+    Submitted = Layer->Producer;
+
+    SplitPlanes( Layer->Canvas, Layer->Planes[ Submitted ][ 0 ], Layer->Planes[ Submitted ][ 1 ], Layer->Device->FramebufferSize );
+
+    /* Whatever was pending is either stale or a set that was never shown, both can be drawn over */
+    Previous = atomic_exchange( &Layer->Pending, ( unsigned int ) Submitted | Gray_Fresh );
+    Layer->Producer = Previous & ~Gray_Fresh;
+
+    atomic_fetch_add( &Layer->Commits, 1 );
+}
+
+void SSD1306_GrayGetStats( struct SSD1306_GrayLayer* Layer, struct SSD1306_GrayStats* Stats ) {
+    int64_t Elapsed = 0;
+
+    NullCheck( Layer, return );
+    NullCheck( Stats, return );
+
+    Stats->PlanesShown = atomic_load( &Layer->PlanesShown );
+    Stats->SlotsMissed = atomic_load( &Layer->SlotsMissed );
+    Stats->Commits = atomic_load( &Layer->Commits );
+    Stats->FlushUs = atomic_load( &Layer->FlushUs );
+
+    Elapsed = GetTimeUs( ) - Layer->StartedUs;
+    Stats->PlaneRate = ( Elapsed > 0 ) ? ( int ) ( ( ( int64_t ) Stats->PlanesShown * 100000000 ) / Elapsed ) : 0;
+}
@@ -0,0 +1,134 @@
+#ifndef _SSD1306_GRAY_H_
+#define _SSD1306_GRAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ssd1306.h"
+
+#if defined ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Apparent gray levels, 0 is off and SSD1306_GRAY_LEVELS - 1 fully lit */
+#define SSD1306_GRAY_LEVELS 4
+
+/*
+ * The high bitplane is shown for two slots and the low one for one,
+ * so a 2 bit level lights a pixel for level thirds of every cycle.
+ */
+#define SSD1306_GRAY_SLOTS_PER_CYCLE 3
+
+/*
+ * 2bpp grayscale on 1bpp panels by temporal dithering.
+ *
+ * Drawing goes into a 2bpp canvas, committing splits it into two 1bpp
+ * bitplanes which a timer driven task keeps flushing to the display
+ * with weighted durations. Committed planes are handed over the same
+ * way the presenter hands over frames, a new pair is picked up at the
+ * start of a cycle so a cycle never mixes two frames.
+ *
+ * Every slot must fit a full frame transfer, in practice this needs SPI
+ * with DMA. While the layer is running only it may talk to the display.
+ */
+struct SSD1306_GrayLayer {
+    struct SSD1306_Device* Device;
+
+    /* Page format, each column of a page is 16 bits holding 2 bits per pixel with row 0 in the lowest */
+    uint16_t* Canvas;
+
+    /* Three sets of high and low bitplanes, each plane is a 1bpp framebuffer */
+    uint8_t* Planes[ 3 ][ 2 ];
+
+    /* Owned by the drawing side and the flushing task respectively */
+    int Producer;
+    int Consumer;
+
+    /* Index of the pending plane set, Gray_Fresh is set until the task takes it */
+    atomic_uint Pending;
+    atomic_bool Running;
+
+    int SlotUs;
+    int Slot;
+
+    atomic_uint PlanesShown;
+    atomic_uint SlotsMissed;
+    atomic_uint Commits;
+
+    /* Duration of the most recent plane transfer */
+    atomic_int FlushUs;
+
+    int64_t StartedUs;
+
+#if defined ESP_PLATFORM
+    esp_timer_handle_t Timer;
+    TaskHandle_t Task;
+    SemaphoreHandle_t Stopped;
+#else
+    pthread_t Thread;
+#endif
+};
+
+#define Gray_Fresh 0x80
+
+struct SSD1306_GrayStats {
+    /* Plane transfers completed since the layer was started */
+    unsigned int PlanesShown;
+
+    /* Slots that passed while the previous transfer was still running */
+    unsigned int SlotsMissed;
+
+    unsigned int Commits;
+
+    /* Achieved plane transfers per second, in hundredths */
+    int PlaneRate;
+
+    /* Duration of the most recent plane transfer in microseconds */
+    int FlushUs;
+};
+
+/*
+ * Allocates the canvas and bitplanes and starts flushing.
+ *
+ * Params:
+ * Layer: Gray layer object, must outlive the task
+ * DeviceHandle: Initialized 1bpp display without strip rendering
+ * SlotUs: Length of the shortest slot, a full cycle takes SSD1306_GRAY_SLOTS_PER_CYCLE of these
+ * Core: CPU to pin the task to, -1 to let the scheduler decide
+ *
+ * Returns false if a frame transfer takes longer than SlotUs, the display
+ * would only flicker at that rate.
+ */
+bool SSD1306_GrayStart( struct SSD1306_GrayLayer* Layer, struct SSD1306_Device* DeviceHandle, int SlotUs, int Core );
+
+/*
+ * Stops flushing and frees the layer, the display is left showing the high bitplane.
+ */
+void SSD1306_GrayStop( struct SSD1306_GrayLayer* Layer );
+
+void SSD1306_GrayDrawPixel( struct SSD1306_GrayLayer* Layer, int X, int Y, int Level );
+void SSD1306_GrayFillBox( struct SSD1306_GrayLayer* Layer, int X0, int Y0, int X1, int Y1, int Level );
+void SSD1306_GrayClear( struct SSD1306_GrayLayer* Layer, int Level );
+
+/*
+ * Splits the canvas into bitplanes and queues them to be shown from the next cycle on.
+ * The canvas keeps its contents.
+ */
+void SSD1306_GrayCommit( struct SSD1306_GrayLayer* Layer );
+
+void SSD1306_GrayGetStats( struct SSD1306_GrayLayer* Layer, struct SSD1306_GrayStats* Stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
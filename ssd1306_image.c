@@ -0,0 +1,280 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_image.h"
+
+/* Thresholds are this many columns wide so a vector register's worth can be loaded at once */
+#define THRESHOLD_COLUMNS 16
+
+static const uint8_t Bayer8x8[ 8 ][ 8 ] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+/* Stands in for rows of a page the image does not cover */
+static const uint8_t BlankRow[ SSD1306_MAX_COLUMNS ];
+
+/*
+ * Packs THRESHOLD_COLUMNS columns of a page at a time.
+ * Comparing a row gives 0xFF for every lit pixel, masking that with
+ * the row's bit and or'ing all 8 rows together yields the page bytes.
+ * Returns the number of columns done, the caller finishes the rest.
+ */
+#if defined __SSE2__
+
+static int PackPageVector( const uint8_t* const* Rows, const uint8_t ( *Thresholds )[ THRESHOLD_COLUMNS ], uint8_t* Out, int Count, uint8_t Mask ) {
+    const __m128i Bias = _mm_set1_epi8( ( char ) 0x80 );
+    const __m128i KeepMask = _mm_set1_epi8( ( char ) Mask );
+    __m128i Limits[ 8 ];
+    __m128i Page;
+    __m128i Pixels;
+    int Column = 0;
+    int Row = 0;
+
+    /* SSE2 only compares signed bytes, flipping the top bit maps unsigned order onto signed */
+    for ( Row = 0; Row < 8; Row++ ) {
+        Limits[ Row ] = _mm_xor_si128( _mm_loadu_si128( ( const __m128i* ) Thresholds[ Row ] ), Bias );
+    }
+
+    for ( Column = 0; Column + THRESHOLD_COLUMNS <= Count; Column+= THRESHOLD_COLUMNS ) {
+        Page = _mm_setzero_si128( );
+
+        for ( Row = 0; Row < 8; Row++ ) {
+            Pixels = _mm_xor_si128( _mm_loadu_si128( ( const __m128i* ) &Rows[ Row ][ Column ] ), Bias );
+            Page = _mm_or_si128( Page, _mm_and_si128( _mm_cmpgt_epi8( Pixels, Limits[ Row ] ), _mm_set1_epi8( ( char ) BIT( Row ) ) ) );
+        }
+
+        Pixels = _mm_loadu_si128( ( const __m128i* ) &Out[ Column ] );
+        Page = _mm_or_si128( _mm_andnot_si128( KeepMask, Pixels ), _mm_and_si128( Page, KeepMask ) );
+
+        _mm_storeu_si128( ( __m128i* ) &Out[ Column ], Page );
+    }
+
+    return Column;
+}
+
+#elif defined __ARM_NEON
+
+static int PackPageVector( const uint8_t* const* Rows, const uint8_t ( *Thresholds )[ THRESHOLD_COLUMNS ], uint8_t* Out, int Count, uint8_t Mask ) {
+    const uint8x16_t KeepMask = vdupq_n_u8( Mask );
+    uint8x16_t Limits[ 8 ];
+    uint8x16_t Page;
+    int Column = 0;
+    int Row = 0;
+
+    for ( Row = 0; Row < 8; Row++ ) {
+        Limits[ Row ] = vld1q_u8( Thresholds[ Row ] );
+    }
+
+    for ( Column = 0; Column + THRESHOLD_COLUMNS <= Count; Column+= THRESHOLD_COLUMNS ) {
+        Page = vdupq_n_u8( 0 );
+
+        for ( Row = 0; Row < 8; Row++ ) {
+            Page = vorrq_u8( Page, vandq_u8( vcgtq_u8( vld1q_u8( &Rows[ Row ][ Column ] ), Limits[ Row ] ), vdupq_n_u8( BIT( Row ) ) ) );
+        }
+
+        vst1q_u8( &Out[ Column ], vbslq_u8( KeepMask, Page, vld1q_u8( &Out[ Column ] ) ) );
+    }
+
+    return Column;
+}
+
+#else
+
+static int PackPageVector( const uint8_t* const* Rows, const uint8_t ( *Thresholds )[ THRESHOLD_COLUMNS ], uint8_t* Out, int Count, uint8_t Mask ) {
+    ( void ) Rows;
+    ( void ) Thresholds;
+    ( void ) Out;
+    ( void ) Count;
+    ( void ) Mask;
+
+    return 0;
+}
+
+#endif
+
+static void PackPage( const uint8_t* const* Rows, const uint8_t ( *Thresholds )[ THRESHOLD_COLUMNS ], uint8_t* Out, int Count, uint8_t Mask ) {
+    uint8_t Page = 0;
+    int Column = 0;
+    int Row = 0;
+
+    for ( Column = PackPageVector( Rows, Thresholds, Out, Count, Mask ); Column < Count; Column++ ) {
+        for ( Page = 0, Row = 0; Row < 8; Row++ ) {
+            Page|= ( Rows[ Row ][ Column ] > Thresholds[ Row ][ Column % THRESHOLD_COLUMNS ] ) ? BIT( Row ) : 0;
+        }
+
+        Out[ Column ] = ( Out[ Column ] & ~Mask ) | ( Page & Mask );
+    }
+}
+
+/*
+ * Threshold and ordered dither, every pixel is independent so the image is done a page at a time.
+ */
+static void DrawOrdered( struct SSD1306_Device* DeviceHandle, const uint8_t* Image, int Stride, int ImageX, int ImageY, int Left, int Right, int Top, int Bottom, SSD1306_DitherMode Mode, int Threshold ) {
+    uint8_t Thresholds[ 8 ][ THRESHOLD_COLUMNS ];
+    const uint8_t* Rows[ 8 ];
+    uint8_t Mask = 0;
+    int Page = 0;
+    int Row = 0;
+    int Y = 0;
+    int i = 0;
+
+    for ( Row = 0; Row < 8; Row++ ) {
+        for ( i = 0; i < THRESHOLD_COLUMNS; i++ ) {
+            /* Scaled to 2..254 so that black never lights up and white always does */
+            Thresholds[ Row ][ i ] = ( Mode == Dither_Bayer ) ? ( Bayer8x8[ Row ][ ( Left + i ) & 0x07 ] * 4 ) + 2 : Threshold;
+        }
+    }
+
+    for ( Page = Top / 8; Page <= Bottom / 8; Page++ ) {
+        for ( Mask = 0, Row = 0; Row < 8; Row++ ) {
+            Y = ( Page * 8 ) + Row;
+
+            if ( Y >= Top && Y <= Bottom ) {
+                Rows[ Row ] = &Image[ ( ( Y - ImageY ) * Stride ) + ( Left - ImageX ) ];
+                Mask|= BIT( Row );
+            } else {
+                Rows[ Row ] = BlankRow;
+            }
+        }
+
+        PackPage( Rows, ( const uint8_t ( * )[ THRESHOLD_COLUMNS ] ) Thresholds, &DeviceHandle->Framebuffer[ ( ( Page - DeviceHandle->FramebufferPage ) * DeviceHandle->BytesPerPage ) + Left ], ( Right - Left ) + 1, Mask );
+    }
+}
+
+/*
+ * Error diffusion has to walk every visible row from the top of the image
+ * even when only a band of it is held in the framebuffer.
+ * Errors are kept for up to three rows with two columns of padding each side.
+ */
+static void DrawDiffused( struct SSD1306_Device* DeviceHandle, const uint8_t* Image, int Stride, int ImageX, int ImageY, int Left, int Right, int Top, int Bottom, int BandTop, SSD1306_DitherMode Mode, int Threshold ) {
+    int16_t Errors[ 3 ][ SSD1306_MAX_COLUMNS + 4 ];
+    int16_t* Current = Errors[ 0 ];
+    int16_t* Next = Errors[ 1 ];
+    int16_t* Later = Errors[ 2 ];
+    int16_t* Swap = NULL;
+    const uint8_t* Pixels = NULL;
+    uint8_t* Page = NULL;
+    uint8_t Bit = 0;
+    int Value = 0;
+    int Error = 0;
+    int Y = 0;
+    int X = 0;
+    int i = 0;
+
+    memset( Errors, 0, sizeof( Errors ) );
+
+    for ( Y = Top; Y <= Bottom; Y++ ) {
+        Pixels = &Image[ ( ( Y - ImageY ) * Stride ) + ( Left - ImageX ) ];
+        Page = ( Y >= BandTop ) ? &DeviceHandle->Framebuffer[ ( ( ( Y >> 3 ) - DeviceHandle->FramebufferPage ) * DeviceHandle->BytesPerPage ) + Left ] : NULL;
+        Bit = BIT( ( Y & 0x07 ) );
+
+        for ( X = 0, i = 2; X <= Right - Left; X++, i++ ) {
+            Value = Pixels[ X ] + Current[ i ];
+            Error = ( Value > Threshold ) ? Value - 255 : Value;
+
+            if ( Page != NULL ) {
+                Page[ X ] = ( Value > Threshold ) ? Page[ X ] | Bit : Page[ X ] & ~Bit;
+            }
+
+            if ( Mode == Dither_FloydSteinberg ) {
+                Current[ i + 1 ]+= ( Error * 7 ) / 16;
+                Next[ i - 1 ]+= ( Error * 3 ) / 16;
+                Next[ i ]+= ( Error * 5 ) / 16;
+                Next[ i + 1 ]+= Error / 16;
+            } else {
+                Error/= 8;
+
+                Current[ i + 1 ]+= Error;
+                Current[ i + 2 ]+= Error;
+                Next[ i - 1 ]+= Error;
+                Next[ i ]+= Error;
+                Next[ i + 1 ]+= Error;
+                Later[ i ]+= Error;
+            }
+        }
+
+        Swap = Current;
+        Current = Next;
+        Next = Later;
+        Later = Swap;
+
+        memset( Later, 0, sizeof( Errors[ 0 ] ) );
+    }
+}
+
+void SSD1306_DrawGrayImage( struct SSD1306_Device* DeviceHandle, const uint8_t* Image, int Width, int Height, int Stride, int x, int y, SSD1306_DitherMode Mode, int Threshold ) {
+    int BandTop = 0;
+    int BandBottom = 0;
+    int Left = 0;
+    int Right = 0;
+    int Top = 0;
+    int Bottom = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Image, return );
+
+    CheckBounds( Stride < Width, return );
+    CheckBounds( Mode != Dither_Bayer && ( Threshold < 0 || Threshold > 255 ), return );
+
+    /* The recorded list would have to keep the image alive */
+    CheckState( DeviceHandle->Recorder != NULL, return );
+    CheckState( DeviceHandle->PixelFormat != PixelFormat_Mono, return );
+
+    BandTop = DeviceHandle->FramebufferPage * 8;
+    BandBottom = ( ( DeviceHandle->FramebufferPage + DeviceHandle->FramebufferPages ) * 8 ) - 1;
+
+    Left = ( x < DeviceHandle->Clip.Left ) ? DeviceHandle->Clip.Left : x;
+    Top = ( y < DeviceHandle->Clip.Top ) ? DeviceHandle->Clip.Top : y;
+    Right = ( x + Width > DeviceHandle->Clip.Right ) ? DeviceHandle->Clip.Right : x + Width - 1;
+    Bottom = ( y + Height > DeviceHandle->Clip.Bottom ) ? DeviceHandle->Clip.Bottom : y + Height - 1;
+    Bottom = ( Bottom > BandBottom ) ? BandBottom : Bottom;
+
+    if ( Left > Right || Top > Bottom ) {
+        ClipDebug( x, y );
+        return;
+    }
+
+    switch ( Mode ) {
+        case Dither_FloydSteinberg:
+        case Dither_Atkinson: {
+            DrawDiffused( DeviceHandle, Image, Stride, x, y, Left, Right, Top, Bottom, BandTop, Mode, Threshold );
+            break;
+        }
+        default: {
+            if ( Top < BandTop ) {
+                Top = BandTop;
+            }
+
+            if ( Top <= Bottom ) {
+                DrawOrdered( DeviceHandle, Image, Stride, x, y, Left, Right, Top, Bottom, Mode, Threshold );
+            }
+
+            break;
+        }
+    }
+}
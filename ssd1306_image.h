@@ -0,0 +1,43 @@
+#ifndef _SSD1306_IMAGE_H_
+#define _SSD1306_IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    /* Pixels brighter than Threshold are lit */
+    Dither_Threshold = 0,
+    /* Ordered dither against an 8x8 Bayer matrix anchored to the screen */
+    Dither_Bayer,
+    /* Error diffusion, Floyd-Steinberg spreads all of the error */
+    Dither_FloydSteinberg,
+    /* Error diffusion, Atkinson spreads 3/4 of the error which keeps more contrast */
+    Dither_Atkinson
+} SSD1306_DitherMode;
+
+/*
+ * Converts an 8bpp grayscale image to 1bpp and writes it straight into the framebuffer.
+ *
+ * Params:
+ * Image: Row major 8bpp pixels, 0 is black
+ * Width, Height: Size of the image in pixels
+ * Stride: Bytes from one image row to the next
+ * x, y: Where the top left pixel of the image goes, the image is clipped to the screen
+ * Mode: How gray levels are turned into lit pixels
+ * Threshold: Gray level pixels must exceed to be lit, not used with Dither_Bayer
+ *
+ * 1bpp framebuffers only. While strip rendering or recording a display list the image
+ * is not drawn, the call is logged and ignored.
+ */
+void SSD1306_DrawGrayImage( struct SSD1306_Device* DeviceHandle, const uint8_t* Image, int Width, int Height, int Stride, int x, int y, SSD1306_DitherMode Mode, int Threshold );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#if ! defined ESP_PLATFORM && defined __linux__
+/* For pthread_setaffinity_np */
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "ssd1306.h"
+#include "ssd1306_presenter.h"
+
+#if defined ESP_PLATFORM
+static const int PresenterStackSize = CONFIG_SSD1306_PRESENTER_STACK_SIZE;
+static const int PresenterPriority = CONFIG_SSD1306_PRESENTER_PRIORITY;
+#endif
+
+/*
+ * Sends the pending frame if there is one, returns false if there was nothing to send.
+ */
+static bool PresentPending( struct SSD1306_Presenter* Presenter ) {
+    unsigned int Pending = 0;
+
+    if ( ( atomic_load( &Presenter->Pending ) & Presenter_Fresh ) == 0 ) {
+        return false;
+    }
+
+    /* Our old buffer becomes the pending one, it is stale so it is not marked fresh */
+    Pending = atomic_exchange( &Presenter->Pending, ( unsigned int ) Presenter->Consumer );
+    Presenter->Consumer = Pending & ~Presenter_Fresh;
+
+    SSD1306_UpdateRegionFrom( Presenter->Device, Presenter->Buffers[ Presenter->Consumer ], &Presenter->Damage[ Presenter->Consumer ] );
+
+    atomic_fetch_add( &Presenter->Presented, 1 );
+
+    return true;
+}
+
+#if defined ESP_PLATFORM
+
+static void PresenterTask( void* Param ) {
+    struct SSD1306_Presenter* Presenter = ( struct SSD1306_Presenter* ) Param;
+
+    while ( atomic_load( &Presenter->Running ) == true ) {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        PresentPending( Presenter );
+    }
+
+    /* Make sure the last frame submitted before stopping is shown */
+    PresentPending( Presenter );
+
+    xSemaphoreGive( Presenter->Stopped );
+    vTaskDelete( NULL );
+}
+
+static bool StartTask( struct SSD1306_Presenter* Presenter, int Core ) {
+    NullCheck( ( Presenter->Stopped = xSemaphoreCreateBinary( ) ), return false );
+
+    if ( xTaskCreatePinnedToCore( PresenterTask, "ssd1306_present", PresenterStackSize, Presenter, PresenterPriority, &Presenter->Task, ( Core < 0 ) ? tskNO_AFFINITY : Core ) != pdPASS ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create presenter task" );
+
+        vSemaphoreDelete( Presenter->Stopped );
+        return false;
+    }
+
+    return true;
+}
+
+static void WakeTask( struct SSD1306_Presenter* Presenter ) {
+    xTaskNotifyGive( Presenter->Task );
+}
+
+static void JoinTask( struct SSD1306_Presenter* Presenter ) {
+    xSemaphoreTake( Presenter->Stopped, portMAX_DELAY );
+    vSemaphoreDelete( Presenter->Stopped );
+}
+
+#else
+
+/*
+ * POSIX backend so the pipeline can be exercised on a host build.
+ * The mutex only protects the wakeup, frames are still handed over lock free.
+ */
+static void* PresenterThread( void* Param ) {
+    struct SSD1306_Presenter* Presenter = ( struct SSD1306_Presenter* ) Param;
+
+    while ( atomic_load( &Presenter->Running ) == true ) {
+        pthread_mutex_lock( &Presenter->Lock );
+
+        while ( Presenter->WakePending == false ) {
+            pthread_cond_wait( &Presenter->Wake, &Presenter->Lock );
+        }
+
+        Presenter->WakePending = false;
+        pthread_mutex_unlock( &Presenter->Lock );
+
+        PresentPending( Presenter );
+    }
+
+    PresentPending( Presenter );
+    return NULL;
+}
+
+static bool StartTask( struct SSD1306_Presenter* Presenter, int Core ) {
+#if defined __linux__
+    cpu_set_t CPUSet;
+#endif
+
+    pthread_mutex_init( &Presenter->Lock, NULL );
+    pthread_cond_init( &Presenter->Wake, NULL );
+    Presenter->WakePending = false;
+
+    if ( pthread_create( &Presenter->Thread, NULL, PresenterThread, Presenter ) != 0 ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create presenter thread" );
+
+        pthread_cond_destroy( &Presenter->Wake );
+        pthread_mutex_destroy( &Presenter->Lock );
+        return false;
+    }
+
+#if defined __linux__
+    if ( Core >= 0 ) {
+        CPU_ZERO( &CPUSet );
+        CPU_SET( Core, &CPUSet );
+
+        pthread_setaffinity_np( Presenter->Thread, sizeof( CPUSet ), &CPUSet );
+    }
+#endif
+
+    return true;
+}
+
+static void WakeTask( struct SSD1306_Presenter* Presenter ) {
+    pthread_mutex_lock( &Presenter->Lock );
+        Presenter->WakePending = true;
+        pthread_cond_signal( &Presenter->Wake );
+    pthread_mutex_unlock( &Presenter->Lock );
+}
+
+static void JoinTask( struct SSD1306_Presenter* Presenter ) {
+    pthread_join( Presenter->Thread, NULL );
+
+    pthread_cond_destroy( &Presenter->Wake );
+    pthread_mutex_destroy( &Presenter->Lock );
+}
+
+#endif
+
+bool SSD1306_PresenterStart( struct SSD1306_Presenter* Presenter, struct SSD1306_Device* DeviceHandle, int Core ) {
+    int i = 0;
+
+    NullCheck( Presenter, return false );
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckBounds( DeviceHandle->StripPages > 0, return false );
+
+    memset( Presenter, 0, sizeof( struct SSD1306_Presenter ) );
+
+    Presenter->Device = DeviceHandle;
+    Presenter->Buffers[ 0 ] = SSD1306_GetScreenFramebuffer( DeviceHandle );
+
+    for ( i = 1; i < 3; i++ ) {
+        if ( ( Presenter->Buffers[ i ] = SSD1306_AllocFramebuffer( DeviceHandle->FramebufferSize ) ) == NULL ) {
+            ESP_LOGE( __FUNCTION__, "Failed to allocate presenter buffers" );
+
+            SSD1306_FreeFramebuffer( Presenter->Buffers[ 1 ] );
+            return false;
+        }
+    }
+
+    Presenter->Producer = 0;
+    Presenter->Consumer = 1;
+
+    atomic_init( &Presenter->Pending, 2 );
+    atomic_init( &Presenter->Running, true );
+    atomic_init( &Presenter->Submitted, 0 );
+    atomic_init( &Presenter->Dropped, 0 );
+    atomic_init( &Presenter->Merged, 0 );
+    atomic_init( &Presenter->Presented, 0 );
+
+    SSD1306_RectSetEmpty( &Presenter->Unsent );
+
+    if ( StartTask( Presenter, Core ) == false ) {
+        SSD1306_FreeFramebuffer( Presenter->Buffers[ 1 ] );
+        SSD1306_FreeFramebuffer( Presenter->Buffers[ 2 ] );
+
+        return false;
+    }
+
+    return true;
+}
+
+void SSD1306_PresenterStop( struct SSD1306_Presenter* Presenter ) {
+    int i = 0;
+
+    NullCheck( Presenter, return );
+    NullCheck( Presenter->Device, return );
+
+    atomic_store( &Presenter->Running, false );
+
+    WakeTask( Presenter );
+    JoinTask( Presenter );
+
+    /* The device keeps the buffer it is drawing into */
+    for ( i = 0; i < 3; i++ ) {
+        if ( i != Presenter->Producer ) {
+            SSD1306_FreeFramebuffer( Presenter->Buffers[ i ] );
+        }
+    }
+
+    Presenter->Device = NULL;
+}
+
+void SSD1306_PresenterSubmitRegion( struct SSD1306_Presenter* Presenter, const struct SSD1306_Rect* Damage, SSD1306_PresentMode Mode ) {
+    unsigned int Previous = 0;
+    uint8_t** Framebuffer = NULL;
+    int Submitted = 0;
+
+    NullCheck( Presenter, return );
+    NullCheck( Presenter->Device, return );
+    NullCheck( Damage, return );
+
+    Submitted = Presenter->Producer;
+
+    /*
+     * We can't know whether the presenter takes the pending frame before we
+     * replace it, so anything not yet confirmed as taken goes out again.
+     */
+    Presenter->Damage[ Submitted ] = Presenter->Unsent;
+
+    SSD1306_RectUnion( &Presenter->Damage[ Submitted ], Damage );
+
+    Previous = atomic_exchange( &Presenter->Pending, ( unsigned int ) Submitted | Presenter_Fresh );
+
+    if ( ( Previous & Presenter_Fresh ) != 0 ) {
+        /* The previous frame was never sent, its damage lives on in this one */
+        Presenter->Unsent = Presenter->Damage[ Submitted ];
+
+        /* However many frames are dropped in a row they all go out in one update */
+        if ( Presenter->Merging == false ) {
+            atomic_fetch_add( &Presenter->Merged, 1 );
+        }
+
+        Presenter->Merging = true;
+        atomic_fetch_add( &Presenter->Dropped, 1 );
+    } else {
+        Presenter->Unsent = *Damage;
+        Presenter->Merging = false;
+    }
+
+    /* Whatever was pending is either stale or an unsent frame we just replaced */
+    Presenter->Producer = Previous & ~Presenter_Fresh;
+
+    /* While drawing goes into a canvas the display's framebuffer is kept in Screen */
+    Framebuffer = ( Presenter->Device->Target != NULL ) ? &Presenter->Device->Screen.Framebuffer : &Presenter->Device->Framebuffer;
+    *Framebuffer = Presenter->Buffers[ Presenter->Producer ];
+
+    atomic_fetch_add( &Presenter->Submitted, 1 );
+
+    /* The presenter only ever reads the submitted buffer so copying from it here is safe */
+    if ( Mode == Present_Copy ) {
+        memcpy( *Framebuffer, Presenter->Buffers[ Submitted ], Presenter->Device->FramebufferSize );
+    }
+
+    WakeTask( Presenter );
+}
+
+void SSD1306_PresenterSubmit( struct SSD1306_Presenter* Presenter, SSD1306_PresentMode Mode ) {
+    struct SSD1306_Rect Screen;
+
+    NullCheck( Presenter, return );
+    NullCheck( Presenter->Device, return );
+
+    Screen.Left = 0;
+    Screen.Top = 0;
+    Screen.Right = Presenter->Device->Screen.Width - 1;
+    Screen.Bottom = Presenter->Device->Screen.Height - 1;
+
+    SSD1306_PresenterSubmitRegion( Presenter, &Screen, Mode );
+}
+
+void SSD1306_PresenterGetStats( struct SSD1306_Presenter* Presenter, struct SSD1306_PresenterStats* Stats ) {
+    NullCheck( Presenter, return );
+    NullCheck( Stats, return );
+
+    Stats->Submitted = atomic_load( &Presenter->Submitted );
+    Stats->Dropped = atomic_load( &Presenter->Dropped );
+    Stats->Merged = atomic_load( &Presenter->Merged );
+    Stats->Presented = atomic_load( &Presenter->Presented );
+}
@@ -0,0 +1,125 @@
+#ifndef _SSD1306_PRESENTER_H_
+#define _SSD1306_PRESENTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ssd1306.h"
+
+#if defined ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hands finished frames over to a task that owns the display transport.
+ *
+ * Three framebuffers are used: one being drawn into, one being sent and
+ * one holding the most recently submitted frame. Submitting exchanges the
+ * drawing buffer with the pending one without locking, if the presenter
+ * has not picked up the pending frame yet it is simply replaced.
+ *
+ * While the presenter is running only it may talk to the display.
+ */
+struct SSD1306_Presenter {
+    struct SSD1306_Device* Device;
+
+    uint8_t* Buffers[ 3 ];
+
+    /* Owned by the drawing side and the presenter task respectively */
+    int Producer;
+    int Consumer;
+
+    /* Index of the pending buffer, Presenter_Fresh is set until the presenter takes it */
+    atomic_uint Pending;
+    atomic_bool Running;
+
+    /*
+     * Area that changed in each buffer.
+     * Written by whichever side owns the buffer at the time.
+     */
+    struct SSD1306_Rect Damage[ 3 ];
+
+    /* Damage submitted by the drawing side that the presenter may not have sent yet */
+    struct SSD1306_Rect Unsent;
+
+    /* Set while the pending frame carries the damage of frames dropped before it */
+    bool Merging;
+
+    atomic_uint Submitted;
+    atomic_uint Dropped;
+    atomic_uint Merged;
+    atomic_uint Presented;
+
+#if defined ESP_PLATFORM
+    TaskHandle_t Task;
+    SemaphoreHandle_t Stopped;
+#else
+    pthread_t Thread;
+    pthread_mutex_t Lock;
+    pthread_cond_t Wake;
+    bool WakePending;
+#endif
+};
+
+#define Presenter_Fresh 0x80
+
+struct SSD1306_PresenterStats {
+    /* Frames handed to SSD1306_PresenterSubmit* */
+    unsigned int Submitted;
+
+    /* Frames replaced by a newer one before they could be sent */
+    unsigned int Dropped;
+
+    /* Updates sent that carried the damage of more than one frame */
+    unsigned int Merged;
+
+    /* Updates actually sent to the display */
+    unsigned int Presented;
+};
+
+/*
+ * Starts the presenter task.
+ *
+ * Params:
+ * Presenter: Presenter object, must outlive the task
+ * DeviceHandle: Initialized display, its framebuffer becomes the first drawing buffer
+ * Core: CPU to pin the task to, -1 to let the scheduler decide
+ *
+ * Returns true on success.
+ */
+bool SSD1306_PresenterStart( struct SSD1306_Presenter* Presenter, struct SSD1306_Device* DeviceHandle, int Core );
+
+/*
+ * Stops the presenter task once it has finished sending, the device keeps the latest drawing buffer.
+ */
+void SSD1306_PresenterStop( struct SSD1306_Presenter* Presenter );
+
+/*
+ * Publishes the contents of DeviceHandle->Framebuffer as the next frame and
+ * returns immediately. Afterwards DeviceHandle->Framebuffer points to a
+ * different buffer, with Present_Copy it holds a copy of the submitted frame.
+ */
+void SSD1306_PresenterSubmit( struct SSD1306_Presenter* Presenter, SSD1306_PresentMode Mode );
+
+/*
+ * As above but only Damage is known to have changed since the last submitted frame.
+ * When frames are submitted faster than the bus can send them the damage of
+ * the skipped frames is merged so that one update brings the display up to date.
+ */
+void SSD1306_PresenterSubmitRegion( struct SSD1306_Presenter* Presenter, const struct SSD1306_Rect* Damage, SSD1306_PresentMode Mode );
+
+void SSD1306_PresenterGetStats( struct SSD1306_Presenter* Presenter, struct SSD1306_PresenterStats* Stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
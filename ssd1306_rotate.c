@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_canvas.h"
+#include "ssd1306_rotate.h"
+
+static inline uint8_t ReverseBits( uint8_t Byte ) {
+    Byte = ( ( Byte & 0xF0 ) >> 4 ) | ( ( Byte & 0x0F ) << 4 );
+    Byte = ( ( Byte & 0xCC ) >> 2 ) | ( ( Byte & 0x33 ) << 2 );
+    Byte = ( ( Byte & 0xAA ) >> 1 ) | ( ( Byte & 0x55 ) << 1 );
+
+    return Byte;
+}
+
+/*
+ * Returns the area of the display showing Area of the canvas.
+ */
+static void GetDisplayRect( const struct SSD1306_RotatedCanvas* Rotated, const struct SSD1306_Rect* Area, struct SSD1306_Rect* Rect ) {
+    int Width = Rotated->Device->Width;
+    int Height = Rotated->Device->Height;
+
+    switch ( Rotated->Rotation ) {
+        case Rotation_90: {
+            Rect->Left = ( Width - 1 ) - Area->Bottom;
+            Rect->Right = ( Width - 1 ) - Area->Top;
+            Rect->Top = Area->Left;
+            Rect->Bottom = Area->Right;
+            break;
+        }
+        case Rotation_180: {
+            Rect->Left = ( Width - 1 ) - Area->Right;
+            Rect->Right = ( Width - 1 ) - Area->Left;
+            Rect->Top = ( Height - 1 ) - Area->Bottom;
+            Rect->Bottom = ( Height - 1 ) - Area->Top;
+            break;
+        }
+        case Rotation_270: {
+            Rect->Left = Area->Top;
+            Rect->Right = Area->Bottom;
+            Rect->Top = ( Height - 1 ) - Area->Right;
+            Rect->Bottom = ( Height - 1 ) - Area->Left;
+            break;
+        }
+        default: {
+            *Rect = *Area;
+            break;
+        }
+    }
+}
+
+/*
+ * Turns the 8x8 block of the canvas at x, y into the display's framebuffer.
+ *
+ * The canvas block is loaded as a 64 bit word of 8 columns, one per byte. Transposing it
+ * gives 8 columns of the display when the canvas is on its side, which column
+ * and page they land in and in which order is all that differs between 90 and 270.
+ */
+static void RotateBlock( struct SSD1306_RotatedCanvas* Rotated, int x, int y ) {
+    const uint8_t* Source = &Rotated->Canvas.Framebuffer[ ( ( y / 8 ) * Rotated->Canvas.BytesPerPage ) + x ];
+    struct SSD1306_Device* DeviceHandle = Rotated->Device;
+    uint8_t* Dest = NULL;
+    uint64_t Block = 0;
+    int i = 0;
+
+    switch ( Rotated->Rotation ) {
+        case Rotation_90: {
+            for ( i = 0; i < 8; i++ ) {
+                Block|= ( uint64_t ) Source[ i ] << ( i * 8 );
+            }
+
+            Block = SSD1306_Transpose8x8( Block );
+
+            /* Canvas row y + i is display column Width - 1 - y - i, canvas columns are display rows */
+            Dest = &DeviceHandle->Framebuffer[ ( ( x / 8 ) * DeviceHandle->BytesPerPage ) + ( DeviceHandle->Width - 1 ) - y ];
+
+            for ( i = 0; i < 8; i++, Block>>= 8 ) {
+                Dest[ -i ] = Block & 0xFF;
+            }
+
+            break;
+        }
+        case Rotation_270: {
+            /* Loading the columns last to first turns the page upside down along with them */
+            for ( i = 0; i < 8; i++ ) {
+                Block|= ( uint64_t ) Source[ 7 - i ] << ( i * 8 );
+            }
+
+            Block = SSD1306_Transpose8x8( Block );
+
+            Dest = &DeviceHandle->Framebuffer[ ( ( ( DeviceHandle->Height - 8 ) - x ) / 8 ) * DeviceHandle->BytesPerPage + y ];
+
+            for ( i = 0; i < 8; i++, Block>>= 8 ) {
+                Dest[ i ] = Block & 0xFF;
+            }
+
+            break;
+        }
+        case Rotation_180: {
+            Dest = &DeviceHandle->Framebuffer[ ( ( ( DeviceHandle->Height - 8 ) - y ) / 8 ) * DeviceHandle->BytesPerPage + ( DeviceHandle->Width - 1 ) - x ];
+
+            for ( i = 0; i < 8; i++ ) {
+                Dest[ -i ] = ReverseBits( Source[ i ] );
+            }
+
+            break;
+        }
+        default: {
+            memcpy( &DeviceHandle->Framebuffer[ ( ( y / 8 ) * DeviceHandle->BytesPerPage ) + x ], Source, 8 );
+            break;
+        }
+    }
+}
+
+bool SSD1306_RotatedInit( struct SSD1306_RotatedCanvas* Rotated, struct SSD1306_Device* DeviceHandle, SSD1306_Rotation Rotation ) {
+    bool Sideways = ( Rotation == Rotation_90 || Rotation == Rotation_270 ) ? true : false;
+
+    NullCheck( Rotated, return false );
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckBounds( Rotation < Rotation_0 || Rotation > Rotation_270, return false );
+    CheckBounds( DeviceHandle->Target != NULL || DeviceHandle->StripPages > 0, return false );
+    CheckBounds( DeviceHandle->PixelFormat != PixelFormat_Mono, return false );
+    CheckBounds( ( DeviceHandle->Width & 0x07 ) != 0 || ( DeviceHandle->Height & 0x07 ) != 0, return false );
+
+    memset( Rotated, 0, sizeof( struct SSD1306_RotatedCanvas ) );
+
+    if ( SSD1306_CanvasInit( &Rotated->Canvas, Sideways ? DeviceHandle->Height : DeviceHandle->Width, Sideways ? DeviceHandle->Width : DeviceHandle->Height, PixelFormat_Mono ) == false ) {
+        return false;
+    }
+
+    Rotated->Device = DeviceHandle;
+    Rotated->Rotation = Rotation;
+
+    SSD1306_RectSetEmpty( &Rotated->Damage );
+    return true;
+}
+
+void SSD1306_RotatedFree( struct SSD1306_RotatedCanvas* Rotated ) {
+    NullCheck( Rotated, return );
+
+    SSD1306_CanvasFree( &Rotated->Canvas );
+    Rotated->Device = NULL;
+}
+
+void SSD1306_RotatedDamage( struct SSD1306_RotatedCanvas* Rotated, const struct SSD1306_Rect* Area ) {
+    struct SSD1306_Rect Damage;
+
+    NullCheck( Rotated, return );
+
+    Damage.Left = 0;
+    Damage.Top = 0;
+    Damage.Right = Rotated->Canvas.Width - 1;
+    Damage.Bottom = Rotated->Canvas.Height - 1;
+
+    if ( Area != NULL ) {
+        SSD1306_RectIntersect( &Damage, Area );
+    }
+
+    SSD1306_RectUnion( &Rotated->Damage, &Damage );
+}
+
+void SSD1306_RotatedFlush( struct SSD1306_RotatedCanvas* Rotated ) {
+    struct SSD1306_Rect Blocks;
+    struct SSD1306_Rect Region;
+    int x = 0;
+    int y = 0;
+
+    NullCheck( Rotated, return );
+    NullCheck( Rotated->Device, return );
+    NullCheck( Rotated->Canvas.Framebuffer, return );
+
+    /* Either may have been set up after RotatedInit */
+    CheckState( Rotated->Device->Target != NULL || Rotated->Device->StripPages > 0, return );
+
+    if ( SSD1306_RectIsEmpty( &Rotated->Damage ) == true ) {
+        return;
+    }
+
+    /* Blocks are turned whole, both sizes are multiples of 8 so they never stick out */
+    Blocks.Left = Rotated->Damage.Left & ~0x07;
+    Blocks.Top = Rotated->Damage.Top & ~0x07;
+    Blocks.Right = Rotated->Damage.Right | 0x07;
+    Blocks.Bottom = Rotated->Damage.Bottom | 0x07;
+
+    for ( y = Blocks.Top; y <= Blocks.Bottom; y+= 8 ) {
+        for ( x = Blocks.Left; x <= Blocks.Right; x+= 8 ) {
+            RotateBlock( Rotated, x, y );
+        }
+    }
+
+    GetDisplayRect( Rotated, &Blocks, &Region );
+    SSD1306_UpdateRegion( Rotated->Device, &Region );
+
+    SSD1306_RectSetEmpty( &Rotated->Damage );
+}
@@ -0,0 +1,66 @@
+#ifndef _SSD1306_ROTATE_H_
+#define _SSD1306_ROTATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "ssd1306_canvas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    Rotation_0 = 0,
+    /* Turned clockwise, the top of the canvas runs down the right edge of the panel */
+    Rotation_90,
+    Rotation_180,
+    /* Turned anticlockwise, the top of the canvas runs up the left edge of the panel */
+    Rotation_270
+} SSD1306_Rotation;
+
+/*
+ * A canvas drawn the right way up for a panel mounted at an angle,
+ * for example a 128x64 panel on its side showing a 64x128 portrait canvas.
+ *
+ * Drawing goes into Rotated->Canvas through SSD1306_SetTarget as with any canvas, so no
+ * coordinates are remapped per pixel. On a flush each damaged 8x8 block is turned with a
+ * bit matrix transpose into the display's framebuffer and the part of the display it covers is sent.
+ */
+struct SSD1306_RotatedCanvas {
+    struct SSD1306_Canvas Canvas;
+    struct SSD1306_Device* Device;
+    SSD1306_Rotation Rotation;
+
+    /* Area of the canvas drawn to since the last flush */
+    struct SSD1306_Rect Damage;
+};
+
+/*
+ * Params:
+ * Rotated: Rotated canvas object
+ * DeviceHandle: Initialized 1bpp display, not strip rendering, its size a multiple of 8 both ways
+ * Rotation: How far the canvas is turned on the panel, 90 and 270 swap width and height
+ *
+ * Returns false if the canvas could not be allocated.
+ */
+bool SSD1306_RotatedInit( struct SSD1306_RotatedCanvas* Rotated, struct SSD1306_Device* DeviceHandle, SSD1306_Rotation Rotation );
+void SSD1306_RotatedFree( struct SSD1306_RotatedCanvas* Rotated );
+
+/*
+ * Adds Area of the canvas to what the next flush sends, NULL for all of it.
+ */
+void SSD1306_RotatedDamage( struct SSD1306_RotatedCanvas* Rotated, const struct SSD1306_Rect* Area );
+
+/*
+ * Turns the damaged blocks into the display's framebuffer and sends them.
+ * The display has to be drawing to its own framebuffer and not strip rendering,
+ * otherwise the call is logged and ignored.
+ */
+void SSD1306_RotatedFlush( struct SSD1306_RotatedCanvas* Rotated );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include "ssd1306.h"
+#include "ssd1306_scheduler.h"
+
+void SSD1306_SchedulerInit( struct SSD1306_Scheduler* Scheduler, struct SSD1306_Device* DeviceHandle, int BytesPerSecond, int MaxBytesPerTick, int AgingTicks ) {
+    NullCheck( Scheduler, return );
+    NullCheck( DeviceHandle, return );
+
+    CheckBounds( BytesPerSecond <= 0, return );
+
+    /* A tick must be able to send at least one byte along with its window */
+    CheckBounds( MaxBytesPerTick <= SSD1306_SCHEDULER_WINDOW_COST, return );
+
+    memset( Scheduler, 0, sizeof( struct SSD1306_Scheduler ) );
+
+    Scheduler->Device = DeviceHandle;
+    Scheduler->BytesPerSecond = BytesPerSecond;
+    Scheduler->MaxBytesPerTick = MaxBytesPerTick;
+    Scheduler->AgingTicks = AgingTicks;
+}
+
+/*
+ * Clips Rect to the screen and widens it to whole pages.
+ * The screen is the display's, whatever drawing is currently pointed at.
+ */
+static bool ClipRegion( struct SSD1306_Device* DeviceHandle, struct SSD1306_Rect* Rect ) {
+    Rect->Left = ( Rect->Left < 0 ) ? 0 : Rect->Left;
+    Rect->Right = ( Rect->Right >= DeviceHandle->Screen.Width ) ? DeviceHandle->Screen.Width - 1 : Rect->Right;
+    Rect->Top = ( Rect->Top < 0 ) ? 0 : Rect->Top & ~0x07;
+    Rect->Bottom = ( Rect->Bottom >= DeviceHandle->Screen.Height ) ? DeviceHandle->Screen.Height - 1 : Rect->Bottom | 0x07;
+
+    return ( SSD1306_RectIsEmpty( Rect ) == true ) ? false : true;
+}
+
+static int GetArea( const struct SSD1306_Rect* Rect ) {
+    return ( ( Rect->Right - Rect->Left ) + 1 ) * ( ( Rect->Bottom - Rect->Top ) + 1 );
+}
+
+static void MergeInto( struct SSD1306_ScheduledRegion* Region, const struct SSD1306_Rect* Rect, int Priority ) {
+    SSD1306_RectUnion( &Region->Rect, Rect );
+
+    Region->Priority = ( Priority > Region->Priority ) ? Priority : Region->Priority;
+
+    /* Start over, chunks already sent may have changed again */
+    Region->Page = Region->Rect.Top / 8;
+    Region->Column = Region->Rect.Left;
+}
+
+void SSD1306_SchedulerAddRegion( struct SSD1306_Scheduler* Scheduler, const struct SSD1306_Rect* Region, int Priority ) {
+    struct SSD1306_ScheduledRegion* Best = NULL;
+    struct SSD1306_ScheduledRegion* Free = NULL;
+    struct SSD1306_Rect Merged;
+    struct SSD1306_Rect Rect;
+    int BestGrowth = INT_MAX;
+    int Growth = 0;
+    int i = 0;
+
+    NullCheck( Scheduler, return );
+    NullCheck( Region, return );
+
+    /* A strip only holds some of the pages, there is nothing to send the rest from */
+    CheckState( Scheduler->Device->StripPages > 0, return );
+
+    Rect = *Region;
+
+    if ( ClipRegion( Scheduler->Device, &Rect ) == false ) {
+        return;
+    }
+
+    for ( i = 0; i < SSD1306_SCHEDULER_MAX_REGIONS; i++ ) {
+        if ( Scheduler->Regions[ i ].Active == false ) {
+            Free = ( Free == NULL ) ? &Scheduler->Regions[ i ] : Free;
+            continue;
+        }
+
+        if ( SSD1306_RectIntersects( &Scheduler->Regions[ i ].Rect, &Rect ) == true ) {
+            MergeInto( &Scheduler->Regions[ i ], &Rect, Priority );
+            return;
+        }
+
+        /* Remember which region would grow the least in case we run out of slots */
+        Merged = Scheduler->Regions[ i ].Rect;
+        SSD1306_RectUnion( &Merged, &Rect );
+
+        Growth = GetArea( &Merged ) - GetArea( &Scheduler->Regions[ i ].Rect );
+
+        if ( Growth < BestGrowth ) {
+            BestGrowth = Growth;
+            Best = &Scheduler->Regions[ i ];
+        }
+    }
+
+    if ( Free != NULL ) {
+        memset( Free, 0, sizeof( struct SSD1306_ScheduledRegion ) );
+
+        Free->Rect = Rect;
+        Free->Priority = Priority;
+        Free->Page = Rect.Top / 8;
+        Free->Column = Rect.Left;
+        Free->Active = true;
+    } else {
+        MergeInto( Best, &Rect, Priority );
+    }
+}
+
+static int GetEffectivePriority( struct SSD1306_Scheduler* Scheduler, const struct SSD1306_ScheduledRegion* Region ) {
+    return Region->Priority + ( ( Scheduler->AgingTicks > 0 ) ? Region->Age / Scheduler->AgingTicks : 0 );
+}
+
+static struct SSD1306_ScheduledRegion* GetNextRegion( struct SSD1306_Scheduler* Scheduler ) {
+    struct SSD1306_ScheduledRegion* Best = NULL;
+    int BestPriority = INT_MIN;
+    int Priority = 0;
+    int i = 0;
+
+    for ( i = 0; i < SSD1306_SCHEDULER_MAX_REGIONS; i++ ) {
+        if ( Scheduler->Regions[ i ].Active == true ) {
+            Priority = GetEffectivePriority( Scheduler, &Scheduler->Regions[ i ] );
+
+            /* Ties go to whichever region has waited longest */
+            if ( Best == NULL || Priority > BestPriority || ( Priority == BestPriority && Scheduler->Regions[ i ].Age > Best->Age ) ) {
+                BestPriority = Priority;
+                Best = &Scheduler->Regions[ i ];
+            }
+        }
+    }
+
+    return Best;
+}
+
+/*
+ * Sends up to Budget bytes of the region's current page, returns the bytes charged.
+ */
+static int SendChunk( struct SSD1306_Scheduler* Scheduler, struct SSD1306_ScheduledRegion* Region, int Budget ) {
+    struct SSD1306_Device* DeviceHandle = Scheduler->Device;
+    const uint8_t* Framebuffer = SSD1306_GetScreenFramebuffer( DeviceHandle );
+    int Length = ( Region->Rect.Right - Region->Column ) + 1;
+
+    Length = ( Length > Budget - SSD1306_SCHEDULER_WINDOW_COST ) ? Budget - SSD1306_SCHEDULER_WINDOW_COST : Length;
+
+    SSD1306_WriteWindow( DeviceHandle, &Framebuffer[ Region->Page * DeviceHandle->Screen.BytesPerPage ], Region->Column, Region->Column + Length - 1, Region->Page, Region->Page );
+
+    Scheduler->BytesSent+= Length;
+    Region->Column+= Length;
+
+    if ( Region->Column > Region->Rect.Right ) {
+        Region->Column = Region->Rect.Left;
+        Region->Page++;
+
+        if ( Region->Page > Region->Rect.Bottom / 8 ) {
+            Region->Active = false;
+        }
+    }
+
+    return Length + SSD1306_SCHEDULER_WINDOW_COST;
+}
+
+int SSD1306_SchedulerTick( struct SSD1306_Scheduler* Scheduler, int ElapsedMs ) {
+    struct SSD1306_ScheduledRegion* Region = NULL;
+    bool Serviced[ SSD1306_SCHEDULER_MAX_REGIONS ];
+    uint32_t BytesSent = 0;
+    int TickBudget = 0;
+    int Refill = 0;
+    int i = 0;
+
+    NullCheck( Scheduler, return 0 );
+    NullCheck( Scheduler->Device, return 0 );
+    NullCheck( Scheduler->Device->Framebuffer, return 0 );
+
+    /* Strip rendering may have been turned on after regions were queued */
+    CheckState( Scheduler->Device->StripPages > 0, return 0 );
+
+    Refill = ( Scheduler->BytesPerSecond * ElapsedMs ) + Scheduler->BudgetRemainder;
+
+    Scheduler->Budget+= Refill / 1000;
+    Scheduler->BudgetRemainder = Refill % 1000;
+    Scheduler->Budget = ( Scheduler->Budget > Scheduler->MaxBytesPerTick ) ? Scheduler->MaxBytesPerTick : Scheduler->Budget;
+
+    BytesSent = Scheduler->BytesSent;
+    TickBudget = Scheduler->Budget;
+
+    memset( Serviced, 0, sizeof( Serviced ) );
+
+    while ( TickBudget > SSD1306_SCHEDULER_WINDOW_COST && ( Region = GetNextRegion( Scheduler ) ) != NULL ) {
+        Serviced[ Region - Scheduler->Regions ] = true;
+        TickBudget-= SendChunk( Scheduler, Region, TickBudget );
+    }
+
+    for ( i = 0; i < SSD1306_SCHEDULER_MAX_REGIONS; i++ ) {
+        if ( Scheduler->Regions[ i ].Active == true ) {
+            Scheduler->Regions[ i ].Age = ( Serviced[ i ] == true ) ? 0 : Scheduler->Regions[ i ].Age + 1;
+        }
+    }
+
+    Scheduler->Budget = TickBudget;
+
+    return ( int ) ( Scheduler->BytesSent - BytesSent );
+}
+
+bool SSD1306_SchedulerIsIdle( struct SSD1306_Scheduler* Scheduler ) {
+    int i = 0;
+
+    NullCheck( Scheduler, return true );
+
+    for ( i = 0; i < SSD1306_SCHEDULER_MAX_REGIONS; i++ ) {
+        if ( Scheduler->Regions[ i ].Active == true ) {
+            return false;
+        }
+    }
+
+    return true;
+}
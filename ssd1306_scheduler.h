@@ -0,0 +1,97 @@
+#ifndef _SSD1306_SCHEDULER_H_
+#define _SSD1306_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSD1306_SCHEDULER_MAX_REGIONS 8
+
+/*
+ * Number of bytes a window change is charged against the budget,
+ * the column and page address commands are 3 bytes each.
+ */
+#define SSD1306_SCHEDULER_WINDOW_COST 6
+
+struct SSD1306_ScheduledRegion {
+    struct SSD1306_Rect Rect;
+    int Priority;
+
+    /* Ticks spent waiting without being serviced */
+    int Age;
+
+    /* Next chunk to be sent */
+    int Page;
+    int Column;
+
+    bool Active;
+};
+
+/*
+ * Trickles dirty regions out to the display a page sized chunk at a time
+ * so that a shared bus is never held for long.
+ *
+ * Every tick the budget grows by BytesPerSecond and at most MaxBytesPerTick
+ * worth of chunks are sent. Regions with a higher priority go first, every
+ * AgingTicks a region waits raises its priority by one so nothing starves.
+ *
+ * Chunks always come from the display's own framebuffer, even while drawing goes into a canvas.
+ * Strip rendering displays hold no whole framebuffer to send from, adding regions and ticking
+ * are logged and refused for them.
+ */
+struct SSD1306_Scheduler {
+    struct SSD1306_Device* Device;
+    struct SSD1306_ScheduledRegion Regions[ SSD1306_SCHEDULER_MAX_REGIONS ];
+
+    int BytesPerSecond;
+    int MaxBytesPerTick;
+    int AgingTicks;
+
+    /* Bytes that may be sent right now */
+    int Budget;
+
+    /* Carries the remainder of BytesPerSecond * ElapsedMs / 1000 between ticks */
+    int BudgetRemainder;
+
+    uint32_t BytesSent;
+};
+
+/*
+ * Params:
+ * Scheduler: Scheduler object
+ * DeviceHandle: Display whose framebuffer is sent
+ * BytesPerSecond: Long term bandwidth the display may use
+ * MaxBytesPerTick: Upper bound on bytes sent by a single SSD1306_SchedulerTick, also caps bursts
+ * AgingTicks: Ticks of waiting that promote a region by one priority level, 0 disables aging
+ */
+void SSD1306_SchedulerInit( struct SSD1306_Scheduler* Scheduler, struct SSD1306_Device* DeviceHandle, int BytesPerSecond, int MaxBytesPerTick, int AgingTicks );
+
+/*
+ * Queues Region to be sent. Overlapping regions are merged and keep the higher priority.
+ */
+void SSD1306_SchedulerAddRegion( struct SSD1306_Scheduler* Scheduler, const struct SSD1306_Rect* Region, int Priority );
+
+/*
+ * Sends as many chunks as the budget allows.
+ *
+ * Params:
+ * ElapsedMs: Time since the previous tick, used to refill the budget
+ *
+ * Returns the number of data bytes sent.
+ */
+int SSD1306_SchedulerTick( struct SSD1306_Scheduler* Scheduler, int ElapsedMs );
+
+/*
+ * Returns true when no regions are waiting to be sent.
+ */
+bool SSD1306_SchedulerIsIdle( struct SSD1306_Scheduler* Scheduler );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
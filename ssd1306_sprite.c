@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_sprite.h"
+
+bool SSD1306_SpriteInit( struct SSD1306_Sprite* Sprite, const struct SSD1306_Bitmap* Image, const struct SSD1306_Bitmap* Mask ) {
+    NullCheck( Sprite, return false );
+    NullCheck( Image, return false );
+    NullCheck( Mask, return false );
+
+    CheckBounds( Image->Width < 1 || Image->Height < 1, return false );
+    CheckBounds( Mask->Width < Image->Width || Mask->Height < Image->Height, return false );
+
+    memset( Sprite, 0, sizeof( struct SSD1306_Sprite ) );
+
+    Sprite->Image = *Image;
+    Sprite->Mask = *Mask;
+
+    /* Unless it sits on a page boundary the sprite touches one more page than its height fills */
+    Sprite->SaveUnder = SSD1306_AllocFramebuffer( Image->Width * ( ( ( Image->Height + 7 ) / 8 ) + 1 ) );
+
+    NullCheck( Sprite->SaveUnder, return false );
+
+    SSD1306_RectSetEmpty( &Sprite->Saved );
+    return true;
+}
+
+void SSD1306_SpriteFree( struct SSD1306_Sprite* Sprite ) {
+    NullCheck( Sprite, return );
+
+    SSD1306_FreeFramebuffer( Sprite->SaveUnder );
+
+    Sprite->SaveUnder = NULL;
+    Sprite->Visible = false;
+}
+
+/*
+ * Area the sprite covers at x, y clipped to what can be drawn on.
+ */
+static bool GetBounds( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite, int x, int y, struct SSD1306_Rect* Bounds ) {
+    Bounds->Left = x;
+    Bounds->Top = y;
+    Bounds->Right = x + Sprite->Image.Width - 1;
+    Bounds->Bottom = y + Sprite->Image.Height - 1;
+
+    SSD1306_RectIntersect( Bounds, &DeviceHandle->Clip );
+
+    return ( SSD1306_RectIsEmpty( Bounds ) == true ) ? false : true;
+}
+
+static void SaveUnder( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite ) {
+    const struct SSD1306_Rect* Saved = &Sprite->Saved;
+    uint8_t* Buffer = Sprite->SaveUnder;
+    int Page = 0;
+
+    for ( Page = Saved->Top / 8; Page <= Saved->Bottom / 8; Page++, Buffer+= Sprite->Image.Width ) {
+        memcpy( Buffer, &DeviceHandle->Framebuffer[ ( Page * DeviceHandle->BytesPerPage ) + Saved->Left ], ( Saved->Right - Saved->Left ) + 1 );
+    }
+}
+
+/*
+ * Only rows the sprite covered are put back, the rest of the top and bottom pages may have changed since.
+ */
+static void RestoreUnder( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite ) {
+    const struct SSD1306_Rect* Saved = &Sprite->Saved;
+    const uint8_t* Buffer = Sprite->SaveUnder;
+    uint8_t* Dest = NULL;
+    uint8_t Mask = 0;
+    int Page = 0;
+    int x = 0;
+
+    for ( Page = Saved->Top / 8; Page <= Saved->Bottom / 8; Page++, Buffer+= Sprite->Image.Width ) {
+        Dest = &DeviceHandle->Framebuffer[ ( Page * DeviceHandle->BytesPerPage ) + Saved->Left ];
+
+        Mask = 0xFF;
+        Mask&= ( Page == Saved->Top / 8 ) ? 0xFF << ( Saved->Top & 0x07 ) : 0xFF;
+        Mask&= ( Page == Saved->Bottom / 8 ) ? 0xFF >> ( 7 - ( Saved->Bottom & 0x07 ) ) : 0xFF;
+
+        if ( Mask == 0xFF ) {
+            memcpy( Dest, Buffer, ( Saved->Right - Saved->Left ) + 1 );
+        } else {
+            for ( x = 0; x <= Saved->Right - Saved->Left; x++ ) {
+                Dest[ x ] = ( Dest[ x ] & ~Mask ) | ( Buffer[ x ] & Mask );
+            }
+        }
+    }
+}
+
+void SSD1306_SpriteHide( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite, struct SSD1306_Rect* Dirty ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Sprite, return );
+    NullCheck( Sprite->SaveUnder, return );
+
+    if ( Dirty != NULL ) {
+        SSD1306_RectSetEmpty( Dirty );
+    }
+
+    if ( Sprite->Visible == false ) {
+        return;
+    }
+
+    if ( SSD1306_RectIsEmpty( &Sprite->Saved ) == false ) {
+        RestoreUnder( DeviceHandle, Sprite );
+
+        if ( Dirty != NULL ) {
+            *Dirty = Sprite->Saved;
+        }
+    }
+
+    SSD1306_RectSetEmpty( &Sprite->Saved );
+    Sprite->Visible = false;
+}
+
+void SSD1306_SpriteShow( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite, int x, int y, struct SSD1306_Rect* OldDirty, struct SSD1306_Rect* NewDirty ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Sprite, return );
+    NullCheck( Sprite->SaveUnder, return );
+
+    /* Saved pages are addressed as if the whole screen was in the framebuffer */
+    CheckState( DeviceHandle->PixelFormat != PixelFormat_Mono, return );
+    CheckState( DeviceHandle->StripPages > 0, return );
+
+    /* The save under reads pixels that a recorder has not drawn yet */
+    CheckState( DeviceHandle->Recorder != NULL, return );
+
+    SSD1306_SpriteHide( DeviceHandle, Sprite, OldDirty );
+
+    Sprite->x = x;
+    Sprite->y = y;
+    Sprite->Visible = true;
+
+    if ( NewDirty != NULL ) {
+        SSD1306_RectSetEmpty( NewDirty );
+    }
+
+    if ( GetBounds( DeviceHandle, Sprite, x, y, &Sprite->Saved ) == false ) {
+        return;
+    }
+
+    SaveUnder( DeviceHandle, Sprite );
+    SSD1306_DrawMaskedBitmap( DeviceHandle, &Sprite->Image, &Sprite->Mask, NULL, x, y );
+
+    if ( NewDirty != NULL ) {
+        *NewDirty = Sprite->Saved;
+    }
+}
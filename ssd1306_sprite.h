@@ -0,0 +1,74 @@
+#ifndef _SSD1306_SPRITE_H_
+#define _SSD1306_SPRITE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "ssd1306_bitmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A bitmap drawn over the scene that can be moved or removed without redrawing the scene.
+ *
+ * Only pixels set in Mask are drawn, lit or not. Before drawing, the
+ * framebuffer pages under the sprite are saved and they are put back
+ * when the sprite moves or is hidden, so the scene under a visible
+ * sprite should not be drawn to.
+ * Needs a 1bpp surface that is not using strip rendering, a sprite has to be
+ * hidden while drawing to the surface it was shown on.
+ */
+struct SSD1306_Sprite {
+    struct SSD1306_Bitmap Image;
+    struct SSD1306_Bitmap Mask;
+
+    /* Framebuffer bytes covered by the sprite, at most one page more than its height needs */
+    uint8_t* SaveUnder;
+
+    /* Where SaveUnder came from, Saved is clipped to the clip rectangle */
+    struct SSD1306_Rect Saved;
+
+    int x;
+    int y;
+    bool Visible;
+};
+
+/*
+ * Params:
+ * Sprite: Sprite object
+ * Image: Pixel values drawn where the mask is set
+ * Mask: Opaque pixels of the sprite, at least as large as Image
+ *
+ * Returns false if the save-under buffer could not be allocated.
+ */
+bool SSD1306_SpriteInit( struct SSD1306_Sprite* Sprite, const struct SSD1306_Bitmap* Image, const struct SSD1306_Bitmap* Mask );
+void SSD1306_SpriteFree( struct SSD1306_Sprite* Sprite );
+
+/*
+ * Draws the sprite at x, y. A sprite that is already visible is moved there.
+ *
+ * Params:
+ * OldDirty: Receives the area restored from the old position, empty if there was none
+ * NewDirty: Receives the area the sprite now covers
+ * Either may be NULL. Both are clipped to the clip rectangle and may overlap.
+ *
+ * Only 1bpp displays drawing straight into the framebuffer are supported, in strip
+ * rendering or while a display list records the call is logged and ignored.
+ */
+void SSD1306_SpriteShow( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite, int x, int y, struct SSD1306_Rect* OldDirty, struct SSD1306_Rect* NewDirty );
+
+/*
+ * Restores the background under a visible sprite.
+ *
+ * Params:
+ * Dirty: Receives the area restored, empty if the sprite was not visible. May be NULL.
+ */
+void SSD1306_SpriteHide( struct SSD1306_Device* DeviceHandle, struct SSD1306_Sprite* Sprite, struct SSD1306_Rect* Dirty );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
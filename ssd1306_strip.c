@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_displaylist.h"
+#include "ssd1306_strip.h"
+
+static bool ReplaceFramebuffer( struct SSD1306_Device* DeviceHandle, int Pages ) {
+    uint8_t* Framebuffer = NULL;
+
+    Framebuffer = SSD1306_AllocFramebuffer( DeviceHandle->BytesPerPage * Pages );
+    NullCheck( Framebuffer, return false );
+
+    SSD1306_FreeFramebuffer( DeviceHandle->Framebuffer );
+
+    DeviceHandle->Framebuffer = Framebuffer;
+    DeviceHandle->FramebufferSize = DeviceHandle->BytesPerPage * Pages;
+    DeviceHandle->FramebufferPage = 0;
+    DeviceHandle->FramebufferPages = Pages;
+
+    return true;
+}
+
+bool SSD1306_SetStripMode( struct SSD1306_Device* DeviceHandle, int PagesPerStrip, struct SSD1306_DisplayList* List ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( List, return false );
+
+    CheckBounds( PagesPerStrip < 1 || PagesPerStrip > ( DeviceHandle->Height / 8 ), return false );
+    CheckBounds( DeviceHandle->FrontBuffer != NULL || DeviceHandle->Target != NULL, return false );
+
+    if ( ReplaceFramebuffer( DeviceHandle, PagesPerStrip ) == false ) {
+        return false;
+    }
+
+    SSD1306_DisplayListReset( List );
+
+    DeviceHandle->StripPages = PagesPerStrip;
+    DeviceHandle->Recorder = List;
+
+    SSD1306_DisplayListRecordClip( DeviceHandle );
+
+    return true;
+}
+
+bool SSD1306_SetFullFramebufferMode( struct SSD1306_Device* DeviceHandle ) {
+    NullCheck( DeviceHandle, return false );
+
+    CheckBounds( DeviceHandle->Target != NULL, return false );
+
+    if ( DeviceHandle->StripPages > 0 ) {
+        if ( ReplaceFramebuffer( DeviceHandle, DeviceHandle->Height / 8 ) == false ) {
+            return false;
+        }
+
+        DeviceHandle->StripPages = 0;
+        DeviceHandle->Recorder = NULL;
+    }
+
+    return true;
+}
+
+void SSD1306_StripUpdate( struct SSD1306_Device* DeviceHandle ) {
+    struct SSD1306_DisplayList* List = NULL;
+    struct SSD1306_Rect Clip;
+    int Pages = 0;
+    int Page = 0;
+    int Count = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+
+    /* The band and the recorder are put away while drawing goes into a canvas */
+    CheckState( DeviceHandle->Target != NULL, return );
+
+    NullCheck( ( List = DeviceHandle->Recorder ), return );
+
+    if ( List->Overflow == true ) {
+        ESP_LOGW( __FUNCTION__, "Display list overflowed, frame is incomplete" );
+    }
+
+    Pages = DeviceHandle->Height / 8;
+
+    /* The list starts out with the clip it was recorded with, the one set last must not apply to all of it */
+    Clip = DeviceHandle->Clip;
+
+    DeviceHandle->Clip.Left = 0;
+    DeviceHandle->Clip.Top = 0;
+    DeviceHandle->Clip.Right = DeviceHandle->Width - 1;
+    DeviceHandle->Clip.Bottom = DeviceHandle->Height - 1;
+
+    for ( Page = 0; Page < Pages; Page+= DeviceHandle->StripPages ) {
+        Count = ( ( Page + DeviceHandle->StripPages ) > Pages ) ? ( Pages - Page ) : DeviceHandle->StripPages;
+
+        DeviceHandle->FramebufferPage = Page;
+        DeviceHandle->FramebufferPages = Count;
+
+        memset( DeviceHandle->Framebuffer, 0, DeviceHandle->BytesPerPage * Count );
+        SSD1306_DisplayListReplay( DeviceHandle, List );
+
+        SSD1306_WriteWindow( DeviceHandle, DeviceHandle->Framebuffer, 0, DeviceHandle->Width - 1, Page, Page + Count - 1 );
+    }
+
+    DeviceHandle->FramebufferPage = 0;
+    DeviceHandle->FramebufferPages = DeviceHandle->StripPages;
+    DeviceHandle->Clip = Clip;
+
+    SSD1306_DisplayListReset( List );
+    SSD1306_DisplayListRecordClip( DeviceHandle );
+}
@@ -0,0 +1,46 @@
+#ifndef _SSD1306_STRIP_H_
+#define _SSD1306_STRIP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SSD1306_Device;
+struct SSD1306_DisplayList;
+
+/*
+ * Replaces the full framebuffer with a buffer holding PagesPerStrip pages.
+ * 
+ * From then on drawing calls are recorded into List instead of being drawn.
+ * SSD1306_Update replays the list once for every strip, sends each strip
+ * to the display and then empties the list for the next frame.
+ * 
+ * Since nothing is retained between frames every strip starts out black.
+ * 
+ * Params:
+ * DeviceHandle: Pointer to your SSD1306_Device object
+ * PagesPerStrip: Number of 8 pixel tall pages rendered at a time
+ * List: Initialized display list which must outlive strip mode
+ * 
+ * Returns true on success.
+ */
+bool SSD1306_SetStripMode( struct SSD1306_Device* DeviceHandle, int PagesPerStrip, struct SSD1306_DisplayList* List );
+
+/*
+ * Restores a full framebuffer and immediate drawing.
+ */
+bool SSD1306_SetFullFramebufferMode( struct SSD1306_Device* DeviceHandle );
+
+/*
+ * Renders and sends every strip, called by SSD1306_Update in strip mode.
+ */
+void SSD1306_StripUpdate( struct SSD1306_Device* DeviceHandle );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,402 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#if ! defined ESP_PLATFORM && defined __linux__
+/* For pthread_setaffinity_np */
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_canvas.h"
+#include "ssd1306_tiled.h"
+
+#if defined ESP_PLATFORM
+static const int TiledStackSize = CONFIG_SSD1306_TILED_STACK_SIZE;
+static const int TiledPriority = CONFIG_SSD1306_TILED_PRIORITY;
+#endif
+
+static void GetTileRect( const struct SSD1306_Tile* Tile, struct SSD1306_Rect* Rect ) {
+    Rect->Left = Tile->X;
+    Rect->Top = Tile->Y;
+    Rect->Right = ( Tile->X + Tile->Device->Width ) - 1;
+    Rect->Bottom = ( Tile->Y + Tile->Device->Height ) - 1;
+}
+
+/*
+ * Copies the damaged part of the canvas into the tile's framebuffer and sends it.
+ */
+static void FlushTile( struct SSD1306_TiledSurface* Surface, struct SSD1306_Tile* Tile ) {
+    struct SSD1306_Rect Region;
+
+    if ( SSD1306_RectIsEmpty( &Tile->Damage ) == true ) {
+        return;
+    }
+
+    Region.Left = Tile->Damage.Left - Tile->X;
+    Region.Top = Tile->Damage.Top - Tile->Y;
+    Region.Right = Tile->Damage.Right - Tile->X;
+    Region.Bottom = Tile->Damage.Bottom - Tile->Y;
+
+    SSD1306_DrawCanvas( Tile->Device, &Surface->Canvas, &Tile->Damage, Region.Left, Region.Top, RasterOp_Copy );
+    SSD1306_UpdateRegion( Tile->Device, &Region );
+
+    SSD1306_RectSetEmpty( &Tile->Damage );
+}
+
+static void FlushBus( struct SSD1306_TiledSurface* Surface, int Bus ) {
+    int i = 0;
+
+    for ( i = 0; i < Surface->TileCount; i++ ) {
+        if ( Surface->Tiles[ i ].Bus == Bus ) {
+            FlushTile( Surface, &Surface->Tiles[ i ] );
+        }
+    }
+}
+
+#if defined ESP_PLATFORM
+
+static void TileTask( void* Param ) {
+    struct SSD1306_TileWorker* Worker = ( struct SSD1306_TileWorker* ) Param;
+    struct SSD1306_TiledSurface* Surface = Worker->Surface;
+
+    while ( true ) {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        if ( atomic_load( &Surface->Running ) == false ) {
+            break;
+        }
+
+        FlushBus( Surface, Worker->Bus );
+        xSemaphoreGive( Surface->Done );
+    }
+
+    xSemaphoreGive( Surface->Done );
+    vTaskDelete( NULL );
+}
+
+static bool StartWorker( struct SSD1306_TileWorker* Worker, int Core ) {
+    if ( xTaskCreatePinnedToCore( TileTask, "ssd1306_tile", TiledStackSize, Worker, TiledPriority, &Worker->Task, ( Core < 0 ) ? tskNO_AFFINITY : Core ) != pdPASS ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create tile task" );
+        return false;
+    }
+
+    return true;
+}
+
+static bool InitWorkers( struct SSD1306_TiledSurface* Surface ) {
+    NullCheck( ( Surface->Done = xSemaphoreCreateCounting( SSD1306_MAX_TILES, 0 ) ), return false );
+    return true;
+}
+
+static void WakeWorkers( struct SSD1306_TiledSurface* Surface ) {
+    int i = 0;
+
+    for ( i = 0; i < Surface->WorkerCount; i++ ) {
+        xTaskNotifyGive( Surface->Workers[ i ].Task );
+    }
+}
+
+static void WaitWorkers( struct SSD1306_TiledSurface* Surface ) {
+    int i = 0;
+
+    for ( i = 0; i < Surface->WorkerCount; i++ ) {
+        xSemaphoreTake( Surface->Done, portMAX_DELAY );
+    }
+}
+
+static void JoinWorkers( struct SSD1306_TiledSurface* Surface ) {
+    WaitWorkers( Surface );
+    vSemaphoreDelete( Surface->Done );
+}
+
+#else
+
+/*
+ * POSIX backend so tiled surfaces can be exercised on a host build.
+ */
+static void* TileThread( void* Param ) {
+    struct SSD1306_TileWorker* Worker = ( struct SSD1306_TileWorker* ) Param;
+    struct SSD1306_TiledSurface* Surface = Worker->Surface;
+
+    while ( true ) {
+        pthread_mutex_lock( &Surface->Lock );
+
+        while ( Worker->WakePending == false ) {
+            pthread_cond_wait( &Surface->Wake, &Surface->Lock );
+        }
+
+        Worker->WakePending = false;
+        pthread_mutex_unlock( &Surface->Lock );
+
+        if ( atomic_load( &Surface->Running ) == false ) {
+            break;
+        }
+
+        FlushBus( Surface, Worker->Bus );
+
+        pthread_mutex_lock( &Surface->Lock );
+            Surface->Finished++;
+            pthread_cond_signal( &Surface->Done );
+        pthread_mutex_unlock( &Surface->Lock );
+    }
+
+    return NULL;
+}
+
+static bool StartWorker( struct SSD1306_TileWorker* Worker, int Core ) {
+#if defined __linux__
+    cpu_set_t CPUSet;
+#endif
+
+    Worker->WakePending = false;
+
+    if ( pthread_create( &Worker->Thread, NULL, TileThread, Worker ) != 0 ) {
+        ESP_LOGE( __FUNCTION__, "Failed to create tile thread" );
+        return false;
+    }
+
+#if defined __linux__
+    if ( Core >= 0 ) {
+        CPU_ZERO( &CPUSet );
+        CPU_SET( Core, &CPUSet );
+
+        pthread_setaffinity_np( Worker->Thread, sizeof( CPUSet ), &CPUSet );
+    }
+#endif
+
+    return true;
+}
+
+static bool InitWorkers( struct SSD1306_TiledSurface* Surface ) {
+    pthread_mutex_init( &Surface->Lock, NULL );
+    pthread_cond_init( &Surface->Wake, NULL );
+    pthread_cond_init( &Surface->Done, NULL );
+
+    Surface->Finished = 0;
+    return true;
+}
+
+static void WakeWorkers( struct SSD1306_TiledSurface* Surface ) {
+    int i = 0;
+
+    pthread_mutex_lock( &Surface->Lock );
+        for ( i = 0; i < Surface->WorkerCount; i++ ) {
+            Surface->Workers[ i ].WakePending = true;
+        }
+
+        pthread_cond_broadcast( &Surface->Wake );
+    pthread_mutex_unlock( &Surface->Lock );
+}
+
+static void WaitWorkers( struct SSD1306_TiledSurface* Surface ) {
+    pthread_mutex_lock( &Surface->Lock );
+        while ( Surface->Finished < Surface->WorkerCount ) {
+            pthread_cond_wait( &Surface->Done, &Surface->Lock );
+        }
+
+        Surface->Finished = 0;
+    pthread_mutex_unlock( &Surface->Lock );
+}
+
+static void JoinWorkers( struct SSD1306_TiledSurface* Surface ) {
+    int i = 0;
+
+    for ( i = 0; i < Surface->WorkerCount; i++ ) {
+        pthread_join( Surface->Workers[ i ].Thread, NULL );
+    }
+
+    pthread_cond_destroy( &Surface->Done );
+    pthread_cond_destroy( &Surface->Wake );
+    pthread_mutex_destroy( &Surface->Lock );
+}
+
+#endif
+
+bool SSD1306_TiledInit( struct SSD1306_TiledSurface* Surface, int Width, int Height ) {
+    NullCheck( Surface, return false );
+
+    memset( Surface, 0, sizeof( struct SSD1306_TiledSurface ) );
+
+    if ( SSD1306_CanvasInit( &Surface->Canvas, Width, Height, PixelFormat_Mono ) == false ) {
+        return false;
+    }
+
+    SSD1306_RectSetEmpty( &Surface->Damage );
+    atomic_init( &Surface->Running, false );
+
+    return true;
+}
+
+void SSD1306_TiledFree( struct SSD1306_TiledSurface* Surface ) {
+    NullCheck( Surface, return );
+
+    if ( atomic_load( &Surface->Running ) == true ) {
+        SSD1306_TiledStop( Surface );
+    }
+
+    SSD1306_CanvasFree( &Surface->Canvas );
+    Surface->TileCount = 0;
+}
+
+bool SSD1306_TiledAddTile( struct SSD1306_TiledSurface* Surface, struct SSD1306_Device* DeviceHandle, int x, int y, SSD1306_TileOrientation Orientation, int Bus ) {
+    struct SSD1306_Tile* Tile = NULL;
+
+    NullCheck( Surface, return false );
+    NullCheck( Surface->Canvas.Framebuffer, return false );
+    NullCheck( DeviceHandle, return false );
+    NullCheck( DeviceHandle->Framebuffer, return false );
+
+    CheckBounds( atomic_load( &Surface->Running ) == true, return false );
+    CheckBounds( Surface->TileCount >= SSD1306_MAX_TILES, return false );
+    CheckBounds( DeviceHandle->Target != NULL || DeviceHandle->StripPages > 0, return false );
+    CheckBounds( DeviceHandle->PixelFormat != PixelFormat_Mono, return false );
+    CheckBounds( x < 0 || ( x + DeviceHandle->Width ) > Surface->Canvas.Width, return false );
+    CheckBounds( y < 0 || ( y + DeviceHandle->Height ) > Surface->Canvas.Height, return false );
+
+    Tile = &Surface->Tiles[ Surface->TileCount++ ];
+
+    Tile->Device = DeviceHandle;
+    Tile->X = x;
+    Tile->Y = y;
+    Tile->Orientation = Orientation;
+    Tile->Bus = Bus;
+
+    SSD1306_RectSetEmpty( &Tile->Damage );
+
+    /* Mirroring both axes is a half turn, the framebuffer stays the right way up */
+    SSD1306_SetHFlip( DeviceHandle, Orientation == TileOrientation_Rotate180 );
+    SSD1306_SetVFlip( DeviceHandle, Orientation == TileOrientation_Rotate180 );
+
+    return true;
+}
+
+static bool HasWorker( const struct SSD1306_TiledSurface* Surface, int Bus ) {
+    int i = 0;
+
+    for ( i = 0; i < Surface->WorkerCount; i++ ) {
+        if ( Surface->Workers[ i ].Bus == Bus ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SSD1306_TiledStart( struct SSD1306_TiledSurface* Surface, int Core ) {
+    struct SSD1306_TileWorker* Worker = NULL;
+    int i = 0;
+
+    NullCheck( Surface, return false );
+    CheckBounds( atomic_load( &Surface->Running ) == true, return false );
+
+    if ( InitWorkers( Surface ) == false ) {
+        return false;
+    }
+
+    atomic_store( &Surface->Running, true );
+    Surface->WorkerCount = 0;
+
+    for ( i = 0; i < Surface->TileCount; i++ ) {
+        if ( HasWorker( Surface, Surface->Tiles[ i ].Bus ) == true ) {
+            continue;
+        }
+
+        Worker = &Surface->Workers[ Surface->WorkerCount ];
+        Worker->Surface = Surface;
+        Worker->Bus = Surface->Tiles[ i ].Bus;
+
+        if ( StartWorker( Worker, Core ) == false ) {
+            SSD1306_TiledStop( Surface );
+            return false;
+        }
+
+        Surface->WorkerCount++;
+    }
+
+    return true;
+}
+
+void SSD1306_TiledStop( struct SSD1306_TiledSurface* Surface ) {
+    NullCheck( Surface, return );
+
+    if ( atomic_load( &Surface->Running ) == false ) {
+        return;
+    }
+
+    atomic_store( &Surface->Running, false );
+
+    WakeWorkers( Surface );
+    JoinWorkers( Surface );
+
+    Surface->WorkerCount = 0;
+}
+
+void SSD1306_TiledDamage( struct SSD1306_TiledSurface* Surface, const struct SSD1306_Rect* Area ) {
+    struct SSD1306_Rect Damage;
+
+    NullCheck( Surface, return );
+
+    Damage.Left = 0;
+    Damage.Top = 0;
+    Damage.Right = Surface->Canvas.Width - 1;
+    Damage.Bottom = Surface->Canvas.Height - 1;
+
+    if ( Area != NULL ) {
+        SSD1306_RectIntersect( &Damage, Area );
+    }
+
+    SSD1306_RectUnion( &Surface->Damage, &Damage );
+}
+
+void SSD1306_TiledFlush( struct SSD1306_TiledSurface* Surface ) {
+    struct SSD1306_Tile* Tile = NULL;
+    bool Damaged = false;
+    int i = 0;
+
+    NullCheck( Surface, return );
+    NullCheck( Surface->Canvas.Framebuffer, return );
+
+    if ( SSD1306_RectIsEmpty( &Surface->Damage ) == true ) {
+        return;
+    }
+
+    for ( i = 0; i < Surface->TileCount; i++ ) {
+        Tile = &Surface->Tiles[ i ];
+
+        /* Drawing through one of the tiles has to have finished */
+        CheckBounds( Tile->Device->Target != NULL, return );
+
+        GetTileRect( Tile, &Tile->Damage );
+        SSD1306_RectIntersect( &Tile->Damage, &Surface->Damage );
+
+        Damaged|= ( SSD1306_RectIsEmpty( &Tile->Damage ) == false );
+    }
+
+    SSD1306_RectSetEmpty( &Surface->Damage );
+
+    if ( Damaged == false ) {
+        return;
+    }
+
+    if ( Surface->WorkerCount == 0 ) {
+        for ( i = 0; i < Surface->TileCount; i++ ) {
+            FlushTile( Surface, &Surface->Tiles[ i ] );
+        }
+
+        return;
+    }
+
+    WakeWorkers( Surface );
+    WaitWorkers( Surface );
+}
@@ -0,0 +1,137 @@
+#ifndef _SSD1306_TILED_H_
+#define _SSD1306_TILED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ssd1306.h"
+#include "ssd1306_canvas.h"
+
+#if defined ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSD1306_MAX_TILES 8
+
+/*
+ * One canvas shown across several displays, such as a row of panels making up a sign.
+ *
+ * Drawing goes into Surface->Canvas through any device pointed at it with SSD1306_SetTarget,
+ * which has to be pointed back at its display before flushing. Each tile shows the part of the
+ * canvas under it. On a flush only the damaged part of each tile is copied into its display's
+ * framebuffer and sent, tiles with no damage are skipped.
+ *
+ * Tiles on different buses are flushed in parallel once SSD1306_TiledStart has created a task
+ * per bus, tiles sharing a bus are flushed one after another by the same task.
+ */
+typedef enum {
+    TileOrientation_Normal = 0,
+    /* Panel mounted upside down, handled by the controller's segment and COM remapping */
+    TileOrientation_Rotate180
+} SSD1306_TileOrientation;
+
+struct SSD1306_Tile {
+    struct SSD1306_Device* Device;
+
+    /* Canvas coordinates of the tile's top left pixel */
+    int X;
+    int Y;
+
+    SSD1306_TileOrientation Orientation;
+    int Bus;
+
+    /* Damage in canvas coordinates handed to the tile by the last flush */
+    struct SSD1306_Rect Damage;
+};
+
+struct SSD1306_TiledSurface;
+
+struct SSD1306_TileWorker {
+    struct SSD1306_TiledSurface* Surface;
+    int Bus;
+
+#if defined ESP_PLATFORM
+    TaskHandle_t Task;
+#else
+    pthread_t Thread;
+    bool WakePending;
+#endif
+};
+
+struct SSD1306_TiledSurface {
+    struct SSD1306_Canvas Canvas;
+
+    struct SSD1306_Tile Tiles[ SSD1306_MAX_TILES ];
+    int TileCount;
+
+    /* Area drawn to since the last flush */
+    struct SSD1306_Rect Damage;
+
+    /* One worker per bus while started, none otherwise */
+    struct SSD1306_TileWorker Workers[ SSD1306_MAX_TILES ];
+    int WorkerCount;
+    atomic_bool Running;
+
+#if defined ESP_PLATFORM
+    /* Given by a worker each time it finishes a flush and when it exits */
+    SemaphoreHandle_t Done;
+#else
+    pthread_mutex_t Lock;
+    pthread_cond_t Wake;
+    pthread_cond_t Done;
+    int Finished;
+#endif
+};
+
+/*
+ * Params:
+ * Surface: Tiled surface object
+ * Width, Height: Size of the canvas spanning all tiles
+ *
+ * Returns false if the canvas could not be allocated.
+ */
+bool SSD1306_TiledInit( struct SSD1306_TiledSurface* Surface, int Width, int Height );
+void SSD1306_TiledFree( struct SSD1306_TiledSurface* Surface );
+
+/*
+ * Shows the part of the canvas at x, y on DeviceHandle.
+ *
+ * Params:
+ * DeviceHandle: Initialized 1bpp display, not strip rendering, its framebuffer holds the tile
+ * x, y: Canvas coordinates of the tile's top left pixel, the tile must lie within the canvas
+ * Orientation: How the panel is mounted
+ * Bus: Tiles with the same number share a bus and are never flushed at the same time
+ */
+bool SSD1306_TiledAddTile( struct SSD1306_TiledSurface* Surface, struct SSD1306_Device* DeviceHandle, int x, int y, SSD1306_TileOrientation Orientation, int Bus );
+
+/*
+ * Starts a flush task for every bus, Core is the CPU to pin them to or -1.
+ * Without it tiles are flushed one after another by the caller.
+ * No tiles may be added while started.
+ */
+bool SSD1306_TiledStart( struct SSD1306_TiledSurface* Surface, int Core );
+void SSD1306_TiledStop( struct SSD1306_TiledSurface* Surface );
+
+/*
+ * Adds Area of the canvas to what the next flush sends, NULL for all of it.
+ */
+void SSD1306_TiledDamage( struct SSD1306_TiledSurface* Surface, const struct SSD1306_Rect* Area );
+
+/*
+ * Sends the damaged part of every tile and returns once all of them are done.
+ */
+void SSD1306_TiledFlush( struct SSD1306_TiledSurface* Surface );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
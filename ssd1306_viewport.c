@@ -0,0 +1,291 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_canvas.h"
+#include "ssd1306_viewport.h"
+
+bool SSD1306_ViewportInit( struct SSD1306_Viewport* Viewport, const struct SSD1306_Canvas* Canvas ) {
+    NullCheck( Viewport, return false );
+    NullCheck( Canvas, return false );
+    NullCheck( Canvas->Framebuffer, return false );
+
+    /* The window is read straight out of the canvas so all of it has to be there */
+    CheckBounds( Canvas->FramebufferPage != 0 || Canvas->FramebufferPages * 8 < Canvas->Height, return false );
+
+    memset( Viewport, 0, sizeof( struct SSD1306_Viewport ) );
+
+    Viewport->Canvas = Canvas;
+    SSD1306_ViewportInvalidate( Viewport, NULL );
+
+    return true;
+}
+
+void SSD1306_ViewportScrollTo( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int x, int y ) {
+    NullCheck( DeviceHandle, return );
+    NullCheck( Viewport, return );
+    NullCheck( Viewport->Canvas, return );
+
+    x = ( x > Viewport->Canvas->Width - DeviceHandle->Width ) ? Viewport->Canvas->Width - DeviceHandle->Width : x;
+    y = ( y > Viewport->Canvas->Height - DeviceHandle->Height ) ? Viewport->Canvas->Height - DeviceHandle->Height : y;
+
+    Viewport->X = ( x < 0 ) ? 0 : x;
+    Viewport->Y = ( y < 0 ) ? 0 : y;
+}
+
+void SSD1306_ViewportScrollBy( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int dx, int dy ) {
+    NullCheck( Viewport, return );
+
+    SSD1306_ViewportScrollTo( DeviceHandle, Viewport, Viewport->X + dx, Viewport->Y + dy );
+}
+
+void SSD1306_ViewportInvalidate( struct SSD1306_Viewport* Viewport, const struct SSD1306_Rect* Area ) {
+    int Row = 0;
+
+    NullCheck( Viewport, return );
+
+    Viewport->Copied = false;
+
+    for ( Row = 0; Row < SSD1306_MAX_PAGES * 8; Row++ ) {
+        if ( Area == NULL || ( Viewport->RAMRows[ Row ] >= Area->Top && Viewport->RAMRows[ Row ] <= Area->Bottom ) ) {
+            Viewport->RAMRows[ Row ] = SSD1306_State_Unknown;
+        }
+    }
+}
+
+/*
+ * What is already in the framebuffer can be moved rather than copied again when
+ * the window moved along one axis, by whole pages if vertically, and part of it is still visible.
+ */
+static bool CanMoveWindow( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int dx, int dy ) {
+    if ( Viewport->Copied == false || DeviceHandle->PixelFormat != PixelFormat_Mono ) {
+        return false;
+    }
+
+    /* Moving bytes around would ignore the clip and whatever is outside the band */
+    if ( DeviceHandle->Clip.Left != 0 || DeviceHandle->Clip.Top != 0 || DeviceHandle->Clip.Right != DeviceHandle->Width - 1 || DeviceHandle->Clip.Bottom != DeviceHandle->Height - 1 ) {
+        return false;
+    }
+
+    if ( DeviceHandle->FramebufferPage != 0 || DeviceHandle->FramebufferPages * 8 < DeviceHandle->Height ) {
+        return false;
+    }
+
+    if ( dx == 0 ) {
+        return ( ( dy & 0x07 ) == 0 && abs( dy ) < DeviceHandle->Height ) ? true : false;
+    }
+
+    return ( dy == 0 && abs( dx ) < DeviceHandle->Width ) ? true : false;
+}
+
+/*
+ * Moves the framebuffer contents by -dx, -dy and returns the part of the window that was exposed.
+ */
+static void MoveWindow( struct SSD1306_Device* DeviceHandle, int dx, int dy, struct SSD1306_Rect* Exposed ) {
+    uint8_t* Framebuffer = DeviceHandle->Framebuffer;
+    int Pages = DeviceHandle->FramebufferPages;
+    int Shift = dy / 8;
+    int Page = 0;
+
+    Exposed->Left = 0;
+    Exposed->Top = 0;
+    Exposed->Right = DeviceHandle->Width - 1;
+    Exposed->Bottom = DeviceHandle->Height - 1;
+
+    if ( Shift > 0 ) {
+        for ( Page = 0; Page < Pages - Shift; Page++ ) {
+            memcpy( &Framebuffer[ Page * DeviceHandle->BytesPerPage ], &Framebuffer[ ( Page + Shift ) * DeviceHandle->BytesPerPage ], DeviceHandle->Width );
+        }
+
+        Exposed->Top = DeviceHandle->Height - dy;
+    } else if ( Shift < 0 ) {
+        for ( Page = Pages - 1; Page >= -Shift; Page-- ) {
+            memcpy( &Framebuffer[ Page * DeviceHandle->BytesPerPage ], &Framebuffer[ ( Page + Shift ) * DeviceHandle->BytesPerPage ], DeviceHandle->Width );
+        }
+
+        Exposed->Bottom = -dy - 1;
+    } else {
+        for ( Page = 0; Page < Pages; Page++, Framebuffer+= DeviceHandle->BytesPerPage ) {
+            memmove( Framebuffer + ( ( dx < 0 ) ? -dx : 0 ), Framebuffer + ( ( dx > 0 ) ? dx : 0 ), DeviceHandle->Width - abs( dx ) );
+        }
+
+        Exposed->Left = ( dx > 0 ) ? DeviceHandle->Width - dx : 0;
+        Exposed->Right = ( dx > 0 ) ? DeviceHandle->Width - 1 : -dx - 1;
+    }
+}
+
+void SSD1306_ViewportCopy( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, struct SSD1306_Rect* Dirty ) {
+    struct SSD1306_Rect Exposed;
+    struct SSD1306_Rect Source;
+    int dx = 0;
+    int dy = 0;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Framebuffer, return );
+    NullCheck( Viewport, return );
+    NullCheck( Viewport->Canvas, return );
+
+    CheckState( DeviceHandle->Recorder != NULL, return );
+
+    if ( Dirty != NULL ) {
+        SSD1306_RectSetEmpty( Dirty );
+    }
+
+    dx = Viewport->X - Viewport->CopiedX;
+    dy = Viewport->Y - Viewport->CopiedY;
+
+    if ( Viewport->Copied == true && dx == 0 && dy == 0 ) {
+        return;
+    }
+
+    if ( CanMoveWindow( DeviceHandle, Viewport, dx, dy ) == true ) {
+        MoveWindow( DeviceHandle, dx, dy, &Exposed );
+    } else {
+        Exposed.Left = 0;
+        Exposed.Top = 0;
+        Exposed.Right = DeviceHandle->Width - 1;
+        Exposed.Bottom = DeviceHandle->Height - 1;
+    }
+
+    Source.Left = Viewport->X + Exposed.Left;
+    Source.Top = Viewport->Y + Exposed.Top;
+    Source.Right = Viewport->X + Exposed.Right;
+    Source.Bottom = Viewport->Y + Exposed.Bottom;
+
+    SSD1306_DrawCanvas( DeviceHandle, Viewport->Canvas, &Source, Exposed.Left, Exposed.Top, RasterOp_Copy );
+
+    Viewport->CopiedX = Viewport->X;
+    Viewport->CopiedY = Viewport->Y;
+    Viewport->Copied = true;
+
+    if ( Dirty != NULL ) {
+        Dirty->Left = 0;
+        Dirty->Top = 0;
+        Dirty->Right = DeviceHandle->Width - 1;
+        Dirty->Bottom = DeviceHandle->Height - 1;
+    }
+}
+
+/*
+ * Canvas row wanted in display RAM row Row.
+ * Rows below the window hold what comes next in the canvas, or what came before once the canvas runs out.
+ */
+static int GetWantedRow( struct SSD1306_Viewport* Viewport, int Row, int RingRows ) {
+    int Wanted = Viewport->Y + ( ( ( Row - Viewport->Y ) % RingRows ) + RingRows ) % RingRows;
+
+    if ( Wanted >= Viewport->Canvas->Height ) {
+        Wanted-= RingRows;
+    }
+
+    return ( Wanted < 0 ) ? SSD1306_State_Unknown : Wanted;
+}
+
+static bool IsRowVisible( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int Row, int RingRows ) {
+    return ( ( ( ( Row - Viewport->Y ) % RingRows ) + RingRows ) % RingRows < DeviceHandle->Height ) ? true : false;
+}
+
+/*
+ * Gathers the display RAM page holding canvas rows Rows[ 0..7 ] from the two canvas pages they span.
+ */
+static void ComposePage( const struct SSD1306_Canvas* Canvas, const int* Rows, int X, int Columns, uint8_t* Out ) {
+    const uint8_t* Source = NULL;
+    int Column = 0;
+    int Bit = 0;
+
+    memset( Out, 0, Columns );
+
+    for ( Bit = 0; Bit < 8; Bit++ ) {
+        if ( Rows[ Bit ] < 0 ) {
+            continue;
+        }
+
+        Source = &Canvas->Framebuffer[ ( ( Rows[ Bit ] >> 3 ) * Canvas->BytesPerPage ) + X ];
+
+        for ( Column = 0; Column < Columns; Column++ ) {
+            Out[ Column ]|= ( ( Source[ Column ] >> ( Rows[ Bit ] & 0x07 ) ) & 0x01 ) << Bit;
+        }
+    }
+}
+
+void SSD1306_ViewportUpdate( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport ) {
+    const struct SSD1306_Canvas* Canvas = NULL;
+    uint8_t Mixed[ SSD1306_MAX_COLUMNS ];
+    int Rows[ 8 ];
+    int RingRows = 0;
+    int RunStart = -1;
+    int RunPage = 0;
+    int Page = 0;
+    int Bit = 0;
+    bool Stale = false;
+
+    NullCheck( DeviceHandle, return );
+    NullCheck( DeviceHandle->Controller, return );
+    NullCheck( Viewport, return );
+    NullCheck( ( Canvas = Viewport->Canvas ), return );
+
+    CheckBounds( DeviceHandle->Target != NULL, return );
+    CheckBounds( DeviceHandle->PixelFormat != PixelFormat_Mono || Canvas->PixelFormat != PixelFormat_Mono, return );
+    CheckBounds( Canvas->Width < Viewport->X + DeviceHandle->Width || Canvas->Height < Viewport->Y + DeviceHandle->Height, return );
+
+    RingRows = DeviceHandle->Controller->MaxHeight;
+
+    if ( Viewport->RAMColumn != Viewport->X ) {
+        SSD1306_ViewportInvalidate( Viewport, NULL );
+        Viewport->RAMColumn = Viewport->X;
+    }
+
+    /*
+     * Pages that line up with canvas pages are sent straight from the canvas, runs of them
+     * together when the canvas is as wide as the display. The page holding the
+     * top of an unaligned window has rows from two canvas pages and is gathered first.
+     */
+    for ( Page = 0; Page <= RingRows / 8; Page++ ) {
+        Stale = false;
+
+        for ( Bit = 0; Page < RingRows / 8 && Bit < 8; Bit++ ) {
+            Rows[ Bit ] = GetWantedRow( Viewport, ( Page * 8 ) + Bit, RingRows );
+
+            if ( IsRowVisible( DeviceHandle, Viewport, ( Page * 8 ) + Bit, RingRows ) == true && Viewport->RAMRows[ ( Page * 8 ) + Bit ] != Rows[ Bit ] ) {
+                Stale = true;
+            }
+        }
+
+        /* The run ends here unless this page carries on from the canvas page before */
+        if ( RunStart >= 0 && ( Stale == false || Rows[ 0 ] != ( RunPage + ( Page - RunStart ) ) * 8 || Rows[ 7 ] != Rows[ 0 ] + 7 || Canvas->BytesPerPage != DeviceHandle->BytesPerPage ) ) {
+            SSD1306_WriteWindow( DeviceHandle, &Canvas->Framebuffer[ ( RunPage * Canvas->BytesPerPage ) + Viewport->X ], 0, DeviceHandle->Width - 1, RunStart, Page - 1 );
+            RunStart = -1;
+        }
+
+        if ( Stale == false ) {
+            continue;
+        }
+
+        if ( ( Rows[ 0 ] & 0x07 ) == 0 && Rows[ 7 ] == Rows[ 0 ] + 7 ) {
+            if ( RunStart < 0 ) {
+                RunStart = Page;
+                RunPage = Rows[ 0 ] / 8;
+            }
+        } else {
+            ComposePage( Canvas, Rows, Viewport->X, DeviceHandle->Width, Mixed );
+            SSD1306_WriteWindow( DeviceHandle, Mixed, 0, DeviceHandle->Width - 1, Page, Page );
+        }
+
+        for ( Bit = 0; Bit < 8; Bit++ ) {
+            Viewport->RAMRows[ ( Page * 8 ) + Bit ] = Rows[ Bit ];
+        }
+    }
+
+    SSD1306_SetDisplayStartLine( DeviceHandle, Viewport->Y );
+}
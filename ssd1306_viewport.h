@@ -0,0 +1,84 @@
+#ifndef _SSD1306_VIEWPORT_H_
+#define _SSD1306_VIEWPORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "ssd1306_canvas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A display sized window onto a canvas larger than the display, such as a map or long table.
+ *
+ * The window is either copied into the framebuffer with SSD1306_ViewportCopy or streamed
+ * straight from the canvas into display RAM with SSD1306_ViewportUpdate.
+ * Both remember what they last produced so panning only moves or sends what was exposed.
+ */
+struct SSD1306_Viewport {
+    const struct SSD1306_Canvas* Canvas;
+
+    /* Canvas coordinates of the top left pixel shown */
+    int X;
+    int Y;
+
+    /* Window last copied into the framebuffer, only valid if Copied is set */
+    int CopiedX;
+    int CopiedY;
+    bool Copied;
+
+    /*
+     * Display RAM is used as a ring of rows with the start line pointing at the top of the window.
+     * RAMRows holds the canvas row in each row of display RAM, -1 if unknown, all of them from column RAMColumn.
+     */
+    int16_t RAMRows[ SSD1306_MAX_PAGES * 8 ];
+    int RAMColumn;
+};
+
+/*
+ * Params:
+ * Viewport: Viewport object
+ * Canvas: What is shown, it must be at least as large as the display
+ */
+bool SSD1306_ViewportInit( struct SSD1306_Viewport* Viewport, const struct SSD1306_Canvas* Canvas );
+
+/*
+ * Moves the window, it is kept inside the canvas.
+ */
+void SSD1306_ViewportScrollTo( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int x, int y );
+void SSD1306_ViewportScrollBy( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, int dx, int dy );
+
+/*
+ * Forgets what was copied or sent for Area of the canvas, NULL for all of it.
+ * Needed after drawing into the canvas, or over the copied window or display RAM.
+ */
+void SSD1306_ViewportInvalidate( struct SSD1306_Viewport* Viewport, const struct SSD1306_Rect* Area );
+
+/*
+ * Copies the window into the current target.
+ * After a pan along one axis, by whole pages vertically, what is still visible is moved and only the
+ * exposed part is copied from the canvas.
+ * While a display list records the call is logged and ignored.
+ *
+ * Params:
+ * Dirty: Receives the area of the target that changed, may be NULL.
+ */
+void SSD1306_ViewportCopy( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport, struct SSD1306_Rect* Dirty );
+
+/*
+ * Sends the window straight from the canvas to the display, without going through the framebuffer.
+ *
+ * Vertical panning moves the display start line and only sends pages holding newly exposed rows,
+ * a one page pan sends one page. Horizontal panning sends the whole window.
+ * 1bpp only. The display shows RAM from the start line until it is set back to 0
+ * with SSD1306_SetDisplayStartLine, do that before going back to SSD1306_Update.
+ */
+void SSD1306_ViewportUpdate( struct SSD1306_Device* DeviceHandle, struct SSD1306_Viewport* Viewport );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * Copyright (c) 2017-2018 Tara Keeling
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "ssd1306_font.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_displaylist.h"
+#include "ssd1306_widget.h"
+
+static void InitWidget( struct SSD1306_Widget* Widget, SSD1306_WidgetType Type, const struct SSD1306_Rect* Bounds ) {
+    memset( Widget, 0, sizeof( struct SSD1306_Widget ) );
+
+    Widget->Type = Type;
+    Widget->Bounds = *Bounds;
+    Widget->Color = SSD_COLOR_WHITE;
+    Widget->Version = 1;
+}
+
+void SSD1306_WidgetInitContainer( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds ) {
+    NullCheck( Widget, return );
+    NullCheck( Bounds, return );
+
+    InitWidget( Widget, Widget_Container, Bounds );
+}
+
+void SSD1306_WidgetInitLabel( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const struct SSD1306_FontDef* Font, const char* Text ) {
+    NullCheck( Widget, return );
+    NullCheck( Bounds, return );
+    NullCheck( Font, return );
+    NullCheck( Text, return );
+
+    InitWidget( Widget, Widget_Label, Bounds );
+
+    Widget->Font = Font;
+    strncpy( Widget->Label.Text, Text, sizeof( Widget->Label.Text ) - 1 );
+}
+
+void SSD1306_WidgetInitNumber( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const struct SSD1306_FontDef* Font, const char* Format, int Value ) {
+    NullCheck( Widget, return );
+    NullCheck( Bounds, return );
+    NullCheck( Font, return );
+    NullCheck( Format, return );
+
+    InitWidget( Widget, Widget_Number, Bounds );
+
+    Widget->Font = Font;
+    Widget->Number.Format = Format;
+    Widget->Number.Value = Value;
+}
+
+void SSD1306_WidgetInitBar( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, int Min, int Max, int Value ) {
+    NullCheck( Widget, return );
+    NullCheck( Bounds, return );
+
+    CheckBounds( Max <= Min, return );
+
+    InitWidget( Widget, Widget_Bar, Bounds );
+
+    Widget->Bar.Min = Min;
+    Widget->Bar.Max = Max;
+    Widget->Bar.Value = Value;
+}
+
+void SSD1306_WidgetInitIcon( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const uint8_t* Data, int Width, int Height ) {
+    NullCheck( Widget, return );
+    NullCheck( Bounds, return );
+    NullCheck( Data, return );
+
+    InitWidget( Widget, Widget_Icon, Bounds );
+
+    Widget->Icon.Data = Data;
+    Widget->Icon.Width = Width;
+    Widget->Icon.Height = Height;
+}
+
+void SSD1306_WidgetAddChild( struct SSD1306_Widget* Parent, struct SSD1306_Widget* Child ) {
+    struct SSD1306_Widget** Link = NULL;
+
+    NullCheck( Parent, return );
+    NullCheck( Child, return );
+
+    /* Children are drawn in the order they were added */
+    for ( Link = &Parent->FirstChild; *Link != NULL; Link = &( *Link )->Next ) {
+    }
+
+    *Link = Child;
+    Child->Next = NULL;
+}
+
+void SSD1306_WidgetInvalidate( struct SSD1306_Widget* Widget ) {
+    NullCheck( Widget, return );
+    Widget->Version++;
+}
+
+void SSD1306_WidgetSetText( struct SSD1306_Widget* Widget, const char* Text ) {
+    NullCheck( Widget, return );
+    NullCheck( Text, return );
+
+    CheckBounds( Widget->Type != Widget_Label, return );
+
+    if ( strncmp( Widget->Label.Text, Text, sizeof( Widget->Label.Text ) - 1 ) != 0 ) {
+        strncpy( Widget->Label.Text, Text, sizeof( Widget->Label.Text ) - 1 );
+        Widget->Version++;
+    }
+}
+
+void SSD1306_WidgetSetValue( struct SSD1306_Widget* Widget, int Value ) {
+    int* Current = NULL;
+
+    NullCheck( Widget, return );
+
+    switch ( Widget->Type ) {
+        case Widget_Number: {
+            Current = &Widget->Number.Value;
+            break;
+        }
+        case Widget_Bar: {
+            /* Values outside of the range look the same, don't redraw for them */
+            Value = ( Value < Widget->Bar.Min ) ? Widget->Bar.Min : Value;
+            Value = ( Value > Widget->Bar.Max ) ? Widget->Bar.Max : Value;
+
+            Current = &Widget->Bar.Value;
+            break;
+        }
+        default: {
+            CheckBounds( Widget->Type != Widget_Number && Widget->Type != Widget_Bar, return );
+            return;
+        }
+    };
+
+    if ( *Current != Value ) {
+        *Current = Value;
+        Widget->Version++;
+    }
+}
+
+void SSD1306_WidgetSetIcon( struct SSD1306_Widget* Widget, const uint8_t* Data ) {
+    NullCheck( Widget, return );
+    NullCheck( Data, return );
+
+    CheckBounds( Widget->Type != Widget_Icon, return );
+
+    if ( Widget->Icon.Data != Data ) {
+        Widget->Icon.Data = Data;
+        Widget->Version++;
+    }
+}
+
+static void DrawText( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Widget, const char* Text ) {
+    const struct SSD1306_FontDef* OldFont = DeviceHandle->Font;
+
+    DeviceHandle->Font = Widget->Font;
+    SSD1306_FontDrawString( DeviceHandle, Widget->Bounds.Left, Widget->Bounds.Top, Text, Widget->Color );
+    DeviceHandle->Font = OldFont;
+}
+
+static void DrawBar( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Widget ) {
+    const struct SSD1306_Rect* Bounds = &Widget->Bounds;
+    int Range = Widget->Bar.Max - Widget->Bar.Min;
+    int Length = 0;
+
+    SSD1306_DrawBox( DeviceHandle, Bounds->Left, Bounds->Top, Bounds->Right, Bounds->Bottom, Widget->Color, false );
+
+    /* Bars fill along their longest side */
+    if ( ( Bounds->Right - Bounds->Left ) >= ( Bounds->Bottom - Bounds->Top ) ) {
+        Length = ( ( Widget->Bar.Value - Widget->Bar.Min ) * ( Bounds->Right - Bounds->Left ) ) / Range;
+
+        if ( Length > 0 ) {
+            SSD1306_DrawBox( DeviceHandle, Bounds->Left, Bounds->Top, Bounds->Left + Length, Bounds->Bottom, Widget->Color, true );
+        }
+    } else {
+        Length = ( ( Widget->Bar.Value - Widget->Bar.Min ) * ( Bounds->Bottom - Bounds->Top ) ) / Range;
+
+        if ( Length > 0 ) {
+            SSD1306_DrawBox( DeviceHandle, Bounds->Left, Bounds->Bottom - Length, Bounds->Right, Bounds->Bottom, Widget->Color, true );
+        }
+    }
+}
+
+static void DrawIcon( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Widget ) {
+    const uint8_t* Data = Widget->Icon.Data;
+    struct SSD1306_Bitmap Bitmap;
+    int x = 0;
+    int y = 0;
+
+    /* Plain colors map onto a raster op, gray levels still need plotting */
+    if ( SSD_COLOR_IS_GRAY( Widget->Color ) == false ) {
+        Bitmap.Data = Data;
+        Bitmap.Width = Widget->Icon.Width;
+        Bitmap.Height = Widget->Icon.Height;
+        Bitmap.Format = BitmapFormat_Page;
+        Bitmap.Stride = 0;
+
+        SSD1306_DrawBitmap( DeviceHandle, &Bitmap, NULL, Widget->Bounds.Left, Widget->Bounds.Top, ( Widget->Color == SSD_COLOR_XOR ) ? RasterOp_Xor : ( Widget->Color == SSD_COLOR_BLACK ) ? RasterOp_AndNot : RasterOp_Or );
+        return;
+    }
+
+    for ( y = 0; y < Widget->Icon.Height; y++ ) {
+        for ( x = 0; x < Widget->Icon.Width; x++ ) {
+            if ( Data[ ( ( y / 8 ) * Widget->Icon.Width ) + x ] & BIT( y & 0x07 ) ) {
+                SSD1306_DrawPixel( DeviceHandle, Widget->Bounds.Left + x, Widget->Bounds.Top + y, Widget->Color );
+            }
+        }
+    }
+}
+
+/*
+ * Narrows the clip, recording the change if need be, so that only Bounds is ever drawn over.
+ */
+static void SetWidgetClip( struct SSD1306_Device* DeviceHandle, const struct SSD1306_Rect* Clip ) {
+    DeviceHandle->Clip = *Clip;
+
+    if ( DeviceHandle->Recorder != NULL ) {
+        SSD1306_DisplayListRecordClip( DeviceHandle );
+    }
+}
+
+static void DrawWidget( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Widget ) {
+    const struct SSD1306_Rect OldClip = DeviceHandle->Clip;
+    struct SSD1306_Rect Clip = DeviceHandle->Clip;
+    char Text[ SSD1306_WIDGET_TEXT_MAX ];
+
+    /* Only Bounds is cleared and reported as damaged, long text and large icons must not spill out of it */
+    SSD1306_RectIntersect( &Clip, &Widget->Bounds );
+    SetWidgetClip( DeviceHandle, &Clip );
+
+    SSD1306_DrawBox( DeviceHandle, Widget->Bounds.Left, Widget->Bounds.Top, Widget->Bounds.Right, Widget->Bounds.Bottom, SSD_COLOR_BLACK, true );
+
+    switch ( Widget->Type ) {
+        case Widget_Label: {
+            DrawText( DeviceHandle, Widget, Widget->Label.Text );
+            break;
+        }
+        case Widget_Number: {
+            snprintf( Text, sizeof( Text ), Widget->Number.Format, Widget->Number.Value );
+            DrawText( DeviceHandle, Widget, Text );
+            break;
+        }
+        case Widget_Bar: {
+            DrawBar( DeviceHandle, Widget );
+            break;
+        }
+        case Widget_Icon: {
+            DrawIcon( DeviceHandle, Widget );
+            break;
+        }
+        default: break;
+    };
+
+    SetWidgetClip( DeviceHandle, &OldClip );
+
+    Widget->DrawnVersion = Widget->Version;
+    Widget->Drawn = true;
+}
+
+static void RenderTree( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Widget, bool Force, struct SSD1306_Rect* Damage ) {
+    struct SSD1306_Widget* Child = NULL;
+
+    if ( Force == true || Widget->Drawn == false || Widget->DrawnVersion != Widget->Version ) {
+        DrawWidget( DeviceHandle, Widget );
+        SSD1306_RectUnion( Damage, &Widget->Bounds );
+
+        /* Clearing our bounds wiped out whatever the children drew */
+        Force = true;
+    }
+
+    for ( Child = Widget->FirstChild; Child != NULL; Child = Child->Next ) {
+        RenderTree( DeviceHandle, Child, Force, Damage );
+    }
+}
+
+bool SSD1306_WidgetRender( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Root, struct SSD1306_Rect* Damage ) {
+    NullCheck( DeviceHandle, return false );
+    NullCheck( Root, return false );
+    NullCheck( Damage, return false );
+
+    SSD1306_RectSetEmpty( Damage );
+    RenderTree( DeviceHandle, Root, false, Damage );
+
+    return ( SSD1306_RectIsEmpty( Damage ) == true ) ? false : true;
+}
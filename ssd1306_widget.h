@@ -0,0 +1,104 @@
+#ifndef _SSD1306_WIDGET_H_
+#define _SSD1306_WIDGET_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SSD1306_FontDef;
+
+#define SSD1306_WIDGET_TEXT_MAX 24
+
+typedef enum {
+    Widget_Container = 0,
+    Widget_Label,
+    Widget_Number,
+    Widget_Bar,
+    Widget_Icon
+} SSD1306_WidgetType;
+
+/*
+ * A node in a retained scene.
+ *
+ * Every change to a widget bumps Version, only widgets whose Version differs
+ * from the one last drawn are rasterized again. Redrawing a widget clears its
+ * bounds first so its children are redrawn along with it.
+ * Drawing is clipped to the bounds, text or icons that do not fit are cut off.
+ * Sibling widgets are expected not to overlap.
+ */
+struct SSD1306_Widget {
+    SSD1306_WidgetType Type;
+    struct SSD1306_Rect Bounds;
+
+    uint32_t Version;
+    uint32_t DrawnVersion;
+    bool Drawn;
+
+    struct SSD1306_Widget* FirstChild;
+    struct SSD1306_Widget* Next;
+
+    const struct SSD1306_FontDef* Font;
+    int Color;
+
+    union {
+        struct {
+            char Text[ SSD1306_WIDGET_TEXT_MAX ];
+        } Label;
+
+        struct {
+            const char* Format;
+            int Value;
+        } Number;
+
+        struct {
+            int Min;
+            int Max;
+            int Value;
+        } Bar;
+
+        /* Page format bitmap, same layout as the framebuffer */
+        struct {
+            const uint8_t* Data;
+            int Width;
+            int Height;
+        } Icon;
+    };
+};
+
+void SSD1306_WidgetInitContainer( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds );
+void SSD1306_WidgetInitLabel( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const struct SSD1306_FontDef* Font, const char* Text );
+void SSD1306_WidgetInitNumber( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const struct SSD1306_FontDef* Font, const char* Format, int Value );
+void SSD1306_WidgetInitBar( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, int Min, int Max, int Value );
+void SSD1306_WidgetInitIcon( struct SSD1306_Widget* Widget, const struct SSD1306_Rect* Bounds, const uint8_t* Data, int Width, int Height );
+
+void SSD1306_WidgetAddChild( struct SSD1306_Widget* Parent, struct SSD1306_Widget* Child );
+
+/*
+ * Setters only bump the version if the value actually changed.
+ */
+void SSD1306_WidgetSetText( struct SSD1306_Widget* Widget, const char* Text );
+void SSD1306_WidgetSetValue( struct SSD1306_Widget* Widget, int Value );
+void SSD1306_WidgetSetIcon( struct SSD1306_Widget* Widget, const uint8_t* Data );
+void SSD1306_WidgetInvalidate( struct SSD1306_Widget* Widget );
+
+/*
+ * Rasterizes every widget under Root that changed since it was last drawn.
+ *
+ * Params:
+ * DeviceHandle: Pointer to your SSD1306_Device object
+ * Root: Top of the widget tree
+ * Damage: Receives the union of the bounds that were redrawn, empty if nothing changed
+ *
+ * Returns true if anything was drawn, pass Damage to SSD1306_UpdateRegion to flush it.
+ */
+bool SSD1306_WidgetRender( struct SSD1306_Device* DeviceHandle, struct SSD1306_Widget* Root, struct SSD1306_Rect* Damage );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif